@@ -0,0 +1,84 @@
+"""Server replication CPU benchmark, replication graph against the legacy net driver path.
+
+For every connection count and driver this starts a dedicated server with -RepBench and that many
+-RepBenchBot clients on this machine, all through the editor executable since the project has no
+server target. The server waits for every client, warms up, times its tick flush and appends one
+row to the results file before it exits (see UReplicationBenchmarkSubsystem). The driver column is
+whatever the server actually ran, so check it says BlasterReplicationGraph and Legacy where expected.
+
+    python Scripts/RepGraphBenchmark.py --editor "C:/UE_5.3/Engine/Binaries/Win64/UnrealEditor-Cmd.exe" \
+        --project "C:/Projects/Blaster/Blaster.uproject" --out Saved/RepBench.csv
+
+Steam is turned off so both drivers run on IpNetDriver, and the legacy runs clear
+ReplicationDriverClassName from the command line instead of editing DefaultEngine.ini.
+"""
+
+import argparse
+import subprocess
+import sys
+import time
+
+LEGACY_OVERRIDES = [
+    "-ini:Engine:[/Script/OnlineSubsystemUtils.IpNetDriver]:ReplicationDriverClassName=",
+    "-ini:Engine:[/Script/OnlineSubsystemSteam.SteamNetDriver]:ReplicationDriverClassName=",
+]
+
+COMMON_ARGS = ["-nullrhi", "-nosound", "-unattended", "-nosplash", "-nosteam", "-log"]
+
+
+def run_one(args, connections, legacy):
+    server_cmd = [
+        args.editor, args.project, args.map, "-server", f"-port={args.port}",
+        "-RepBench", f"-RepBenchConnections={connections}", f"-RepBenchWarmup={args.warmup}",
+        f"-RepBenchSeconds={args.seconds}", f"-RepBenchOut={args.out}",
+    ] + COMMON_ARGS
+    if legacy:
+        server_cmd += LEGACY_OVERRIDES
+
+    client_cmd = [args.editor, args.project, f"127.0.0.1:{args.port}", "-game", "-RepBenchBot"] + COMMON_ARGS
+
+    print(f"{'legacy' if legacy else 'graph'}, {connections} connections")
+    server = subprocess.Popen(server_cmd)
+    clients = []
+    try:
+        time.sleep(args.server_startup)
+        for _ in range(connections):
+            clients.append(subprocess.Popen(client_cmd, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL))
+            #joining all at once can time out the handshakes on a busy machine
+            time.sleep(args.join_interval)
+
+        timeout = args.connect_timeout + args.warmup + args.seconds
+        try:
+            server.wait(timeout=timeout)
+        except subprocess.TimeoutExpired:
+            print(f"  server still running after {timeout} s, no row written for this run", file=sys.stderr)
+            server.kill()
+    finally:
+        for client in clients:
+            client.kill()
+        for client in clients:
+            client.wait()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--editor", required=True, help="UnrealEditor-Cmd executable")
+    parser.add_argument("--project", required=True, help="Blaster.uproject")
+    parser.add_argument("--map", default="/Game/Maps/BlasterMap")
+    parser.add_argument("--out", required=True, help="results csv, rows are appended")
+    parser.add_argument("--connections", type=int, nargs="+", default=[16, 32, 64])
+    parser.add_argument("--warmup", type=float, default=10.0)
+    parser.add_argument("--seconds", type=float, default=60.0)
+    parser.add_argument("--port", type=int, default=7777)
+    parser.add_argument("--server-startup", type=float, default=20.0, help="seconds to wait before starting clients")
+    parser.add_argument("--join-interval", type=float, default=0.5)
+    parser.add_argument("--connect-timeout", type=float, default=300.0)
+    args = parser.parse_args()
+
+    for connections in args.connections:
+        for legacy in (False, True):
+            run_one(args, connections, legacy)
+
+
+if __name__ == "__main__":
+    main()
@@ -2,5 +2,80 @@
 
 #include "Blaster.h"
 #include "Modules/ModuleManager.h"
+#include "HAL/IConsoleManager.h"
+#include "EngineUtils.h"
+#include "Engine/World.h"
+#include "Engine/NetDriver.h"
+#include "Engine/NetConnection.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "Blaster/Character/BlasterCharacter.h"
 
 IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, Blaster, "Blaster" );
+
+//counts the replicated actors this machine has authority over by dormancy. Only meaningful on the server
+static FAutoConsoleCommandWithWorld DormancyStatsCommand(
+	TEXT("Blaster.DormancyStats"),
+	TEXT("Prints how many replicated actors are dormant and how many are awake"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if(World == nullptr) {return;}
+
+		int32 NumDormant = 0;
+		int32 NumAwake = 0;
+		int32 NumNeverDormant = 0;
+		for(TActorIterator<AActor> It(World); It; ++It){
+			const AActor* Actor = *It;
+			if(!Actor->GetIsReplicated() || !Actor->HasAuthority()) {continue;}
+
+			switch(Actor->NetDormancy){
+				case DORM_Never:
+					++NumNeverDormant;
+					break;
+				case DORM_Awake:
+					++NumAwake;
+					break;
+				default:
+					++NumDormant;
+					break;
+			}
+		}
+		UE_LOG(LogTemp, Display, TEXT("Dormancy: %d dormant, %d awake, %d never dormant"), NumDormant, NumAwake, NumNeverDormant);
+	}));
+
+//bandwidth to and from every client connection, plus the net update rates the characters are running at. Server only
+static FAutoConsoleCommandWithWorld NetStatsCommand(
+	TEXT("Blaster.NetStats"),
+	TEXT("Prints bytes per second for each client connection and the current character net update rates"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		UNetDriver* NetDriver = World ? World->GetNetDriver() : nullptr;
+		if(NetDriver == nullptr || NetDriver->ClientConnections.Num() == 0){
+			UE_LOG(LogTemp, Display, TEXT("NetStats: no client connections"));
+			return;
+		}
+
+		int32 TotalOutBytes = 0;
+		int32 TotalInBytes = 0;
+		for(const UNetConnection* Connection : NetDriver->ClientConnections){
+			if(Connection == nullptr) {continue;}
+
+			const APlayerController* PlayerController = Connection->PlayerController;
+			const FString Name = PlayerController && PlayerController->PlayerState ? PlayerController->PlayerState->GetPlayerName() : Connection->LowLevelGetRemoteAddress();
+			UE_LOG(LogTemp, Display, TEXT("NetStats: %s out %d B/s, in %d B/s, ping %.0f ms"), *Name, Connection->OutBytesPerSecond, Connection->InBytesPerSecond, Connection->AvgLag * 1000.f);
+			TotalOutBytes += Connection->OutBytesPerSecond;
+			TotalInBytes += Connection->InBytesPerSecond;
+		}
+		const int32 NumConnections = NetDriver->ClientConnections.Num();
+		UE_LOG(LogTemp, Display, TEXT("NetStats: %d connections, out %d B/s (%d per player), in %d B/s"), NumConnections, TotalOutBytes, TotalOutBytes / NumConnections, TotalInBytes);
+
+		int32 NumCharacters = 0;
+		float TotalFrequency = 0.f;
+		for(TActorIterator<ABlasterCharacter> It(World); It; ++It){
+			++NumCharacters;
+			TotalFrequency += It->NetUpdateFrequency;
+		}
+		if(NumCharacters > 0){
+			UE_LOG(LogTemp, Display, TEXT("NetStats: %d characters averaging %.1f net updates per second"), NumCharacters, TotalFrequency / NumCharacters);
+		}
+	}));
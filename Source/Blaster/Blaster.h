@@ -4,4 +4,7 @@
 
 #include "CoreMinimal.h"
 
-#define ECC_SkeletalMesh ECollisionChannel::ECC_GameTraceChannel1
\ No newline at end of file
+#define ECC_SkeletalMesh ECollisionChannel::ECC_GameTraceChannel1
+#define ECC_HitBox ECollisionChannel::ECC_GameTraceChannel2
+
+DECLARE_STATS_GROUP(TEXT("Blaster"), STATGROUP_Blaster, STATCAT_Advanced);
@@ -0,0 +1,113 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "BlasterCharacterMovementComponent.h"
+#include "GameFramework/Character.h"
+#include "Blaster/Character/BlasterCharacter.h"
+#include "CombatComponent.h"
+
+//FLAG_WantsToCrouch already carries crouching, the custom flags after this one are free for sprinting and the like
+static constexpr uint8 FLAG_WantsToAim = FSavedMove_Character::FLAG_Custom_0;
+
+UBlasterCharacterMovementComponent::UBlasterCharacterMovementComponent()
+{
+	MaxWalkSpeed = 600.f;
+}
+
+float UBlasterCharacterMovementComponent::GetMaxSpeed() const
+{
+	if(bWantsToAim && IsMovingOnGround() && !IsCrouching()){
+		return AimWalkSpeed * SpeedMultiplier;
+	}
+	return Super::GetMaxSpeed() * SpeedMultiplier;
+}
+
+void UBlasterCharacterMovementComponent::SetWantsToAim(bool bAim)
+{
+	bWantsToAim = bAim;
+}
+
+void UBlasterCharacterMovementComponent::SetBuffMultipliers(float InSpeedMultiplier, float InJumpMultiplier)
+{
+	SpeedMultiplier = InSpeedMultiplier;
+	//always from the archetype, so a jump buff replacing another one doesn't scale the already scaled velocity
+	JumpZVelocity = CastChecked<UBlasterCharacterMovementComponent>(GetArchetype())->JumpZVelocity * InJumpMultiplier;
+}
+
+void UBlasterCharacterMovementComponent::UpdateFromCompressedFlags(uint8 Flags)
+{
+	Super::UpdateFromCompressedFlags(Flags);
+
+	//this is the server running a client's move. Aiming is also what the animation of everyone else's copy of this
+	//character uses, so it goes into the combat component's replicated flag from here
+	const bool bAimFlag = (Flags & FLAG_WantsToAim) != 0;
+	if(bAimFlag != bWantsToAim){
+		bWantsToAim = bAimFlag;
+
+		ABlasterCharacter* BlasterCharacter = Cast<ABlasterCharacter>(CharacterOwner);
+		if(BlasterCharacter && BlasterCharacter->GetCombat()){
+			BlasterCharacter->GetCombat()->SetAimingFromMove(bWantsToAim);
+		}
+	}
+}
+
+FNetworkPredictionData_Client* UBlasterCharacterMovementComponent::GetPredictionData_Client() const
+{
+	if(ClientPredictionData == nullptr){
+		UBlasterCharacterMovementComponent* MutableThis = const_cast<UBlasterCharacterMovementComponent*>(this);
+		MutableThis->ClientPredictionData = new FNetworkPredictionData_Client_Blaster(*this);
+	}
+	return ClientPredictionData;
+}
+
+void FSavedMove_Blaster::Clear()
+{
+	Super::Clear();
+	bSavedWantsToAim = false;
+}
+
+uint8 FSavedMove_Blaster::GetCompressedFlags() const
+{
+	uint8 Result = Super::GetCompressedFlags();
+	if(bSavedWantsToAim){
+		Result |= FLAG_WantsToAim;
+	}
+	return Result;
+}
+
+bool FSavedMove_Blaster::CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const
+{
+	//moves at two different speeds can't be sent as one
+	if(bSavedWantsToAim != static_cast<FSavedMove_Blaster*>(NewMove.Get())->bSavedWantsToAim){
+		return false;
+	}
+	return Super::CanCombineWith(NewMove, InCharacter, MaxDelta);
+}
+
+void FSavedMove_Blaster::SetMoveFor(ACharacter* C, float InDeltaTime, FVector const& NewAccel, FNetworkPredictionData_Client_Character& ClientData)
+{
+	Super::SetMoveFor(C, InDeltaTime, NewAccel, ClientData);
+
+	if(const UBlasterCharacterMovementComponent* BlasterMovement = Cast<UBlasterCharacterMovementComponent>(C->GetCharacterMovement())){
+		bSavedWantsToAim = BlasterMovement->WantsToAim();
+	}
+}
+
+void FSavedMove_Blaster::PrepMoveFor(ACharacter* C)
+{
+	Super::PrepMoveFor(C);
+
+	if(UBlasterCharacterMovementComponent* BlasterMovement = Cast<UBlasterCharacterMovementComponent>(C->GetCharacterMovement())){
+		BlasterMovement->SetWantsToAim(bSavedWantsToAim);
+	}
+}
+
+FNetworkPredictionData_Client_Blaster::FNetworkPredictionData_Client_Blaster(const UCharacterMovementComponent& ClientMovement)
+	: Super(ClientMovement)
+{
+}
+
+FSavedMovePtr FNetworkPredictionData_Client_Blaster::AllocateNewMove()
+{
+	return FSavedMovePtr(new FSavedMove_Blaster());
+}
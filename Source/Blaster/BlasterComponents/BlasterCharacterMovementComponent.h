@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "BlasterCharacterMovementComponent.generated.h"
+
+/**
+ * Character movement that knows about aiming. Aiming goes to the server as a bit in the compressed flags of every
+ * move, so the slower aim speed is predicted, checked by the server on the same move, and replayed when the client
+ * is corrected, instead of arriving through a separate RPC a few frames out of step with the moves
+ */
+UCLASS()
+class BLASTER_API UBlasterCharacterMovementComponent : public UCharacterMovementComponent
+{
+	GENERATED_BODY()
+
+public:
+	UBlasterCharacterMovementComponent();
+
+	virtual float GetMaxSpeed() const override;
+	virtual void UpdateFromCompressedFlags(uint8 Flags) override;
+	virtual FNetworkPredictionData_Client* GetPredictionData_Client() const override;
+
+	void SetWantsToAim(bool bAim);
+	FORCEINLINE bool WantsToAim() const { return bWantsToAim; }
+
+	//from the buff component, scales every max speed and the jump velocity this component was set up with
+	void SetBuffMultipliers(float InSpeedMultiplier, float InJumpMultiplier);
+
+	//max walk speed while aiming, crouching still uses MaxWalkSpeedCrouched
+	UPROPERTY(Category = "Character Movement: Walking", EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0", UIMin = "0", ForceUnits = "cm/s"))
+	float AimWalkSpeed = 450.f;
+
+private:
+
+	bool bWantsToAim = false;
+	float SpeedMultiplier = 1.f;
+};
+
+//a saved move that also remembers whether the character was aiming, so the move is replayed at the right speed
+class FSavedMove_Blaster : public FSavedMove_Character
+{
+public:
+	typedef FSavedMove_Character Super;
+
+	virtual void Clear() override;
+	virtual uint8 GetCompressedFlags() const override;
+	virtual bool CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const override;
+	virtual void SetMoveFor(ACharacter* C, float InDeltaTime, FVector const& NewAccel, class FNetworkPredictionData_Client_Character& ClientData) override;
+	virtual void PrepMoveFor(ACharacter* C) override;
+
+	uint8 bSavedWantsToAim : 1;
+};
+
+class FNetworkPredictionData_Client_Blaster : public FNetworkPredictionData_Client_Character
+{
+public:
+	typedef FNetworkPredictionData_Client_Character Super;
+
+	FNetworkPredictionData_Client_Blaster(const UCharacterMovementComponent& ClientMovement);
+
+	virtual FSavedMovePtr AllocateNewMove() override;
+};
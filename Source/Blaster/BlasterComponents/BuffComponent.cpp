@@ -3,10 +3,16 @@
 
 #include "BuffComponent.h"
 #include "Blaster/Character/BlasterCharacter.h"
+#include "BlasterCharacterMovementComponent.h"
+#include "Blaster/PlayerController/BlasterPlayerController.h"
+#include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
 
 UBuffComponent::UBuffComponent()
 {
 	PrimaryComponentTick.bCanEverTick = true;
+	//only switched on while there are buffs to run
+	PrimaryComponentTick.bStartWithTickEnabled = false;
 
 }
 
@@ -16,25 +22,183 @@ void UBuffComponent::BeginPlay()
 
 }
 
+void UBuffComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	//proxies need the speed too, or they would keep extrapolating a buffed character at its normal speed
+	FDoRepLifetimeParams PushParams;
+	PushParams.bIsPushBased = true;
+	DOREPLIFETIME_WITH_PARAMS_FAST(UBuffComponent, BuffState, PushParams);
+}
+
 void UBuffComponent::Heal(float HealAmount, float HealingTime)
 {
-	bHealing = true;
-	HealingRate = HealAmount / HealingTime;
-	AmountToHeal += HealAmount;
+	FActiveBuff NewBuff;
+	NewBuff.Type = EBuffType::EBT_Heal;
+	NewBuff.Magnitude = HealAmount;
+	NewBuff.Rate = HealAmount / FMath::Max(HealingTime, KINDA_SMALL_NUMBER);
+	AddBuff(NewBuff);
+}
+
+void UBuffComponent::ReplenishShield(float ShieldAmount, float ReplenishTime)
+{
+	FActiveBuff NewBuff;
+	NewBuff.Type = EBuffType::EBT_Shield;
+	NewBuff.Magnitude = ShieldAmount;
+	NewBuff.Rate = ShieldAmount / FMath::Max(ReplenishTime, KINDA_SMALL_NUMBER);
+	AddBuff(NewBuff);
+}
+
+void UBuffComponent::BuffSpeed(float SpeedMultiplier, float BuffTime)
+{
+	FActiveBuff NewBuff;
+	NewBuff.Type = EBuffType::EBT_Speed;
+	NewBuff.Magnitude = SpeedMultiplier;
+	NewBuff.TimeRemaining = BuffTime;
+	AddBuff(NewBuff);
+}
+
+void UBuffComponent::BuffJump(float JumpMultiplier, float BuffTime)
+{
+	FActiveBuff NewBuff;
+	NewBuff.Type = EBuffType::EBT_Jump;
+	NewBuff.Magnitude = JumpMultiplier;
+	NewBuff.TimeRemaining = BuffTime;
+	AddBuff(NewBuff);
+}
+
+void UBuffComponent::AddBuff(const FActiveBuff& NewBuff)
+{
+	if(Character == nullptr || !Character->HasAuthority()) {return;}
+
+	ActiveBuffs.Add(NewBuff);
+	//running it for no time applies speed and jump right away instead of on the next tick
+	ProcessBuffs(0.f);
+}
+
+float UBuffComponent::AbsorbDamage(float Damage)
+{
+	if(BuffState.Shield <= 0.f) {return Damage;}
+
+	FBuffState NewState = BuffState;
+	const float Absorbed = FMath::Min(Damage, NewState.Shield);
+	NewState.Shield -= Absorbed;
+	SetBuffState(NewState);
+	return Damage - Absorbed;
+}
+
+void UBuffComponent::ResetForRespawn()
+{
+	ActiveBuffs.Reset();
+	SetBuffState(FBuffState());
+	SetComponentTickEnabled(false);
+}
+
+//takes this frame's share of a heal or shield buff out of what it has left to give
+static float RampUp(FActiveBuff& Buff, float DeltaTime)
+{
+	const float Amount = FMath::Min(Buff.Rate * DeltaTime, Buff.Magnitude);
+	Buff.Magnitude -= Amount;
+	return Amount;
 }
 
-void UBuffComponent::HealRampUp(float DeltaTime)
+void UBuffComponent::ProcessBuffs(float DeltaTime)
 {
-	if(!bHealing || Character == nullptr || Character->IsElimmed()) return;
+	if(Character == nullptr) {return;}
+	if(Character->IsElimmed()){
+		//an eliminated character loses whatever it had left
+		ResetForRespawn();
+		return;
+	}
 
-	const float HealThisFrame = HealingRate * DeltaTime;
-	Character->SetHealth(FMath::Clamp(Character->GetHealth() + HealThisFrame, 0.f, Character->GetMaxHealth()));
-	Character->UpdateHUDHealth();
-	AmountToHeal -= HealThisFrame;
+	float HealThisFrame = 0.f;
+	float ShieldThisFrame = 0.f;
+	float SpeedMultiplier = 1.f;
+	float JumpMultiplier = 1.f;
+	for(FActiveBuff& Buff : ActiveBuffs){
+		switch(Buff.Type){
+		case EBuffType::EBT_Heal:
+			HealThisFrame += RampUp(Buff, DeltaTime);
+			break;
+		case EBuffType::EBT_Shield:
+			ShieldThisFrame += RampUp(Buff, DeltaTime);
+			break;
+		case EBuffType::EBT_Speed:
+			Buff.TimeRemaining -= DeltaTime;
+			if(Buff.TimeRemaining > 0.f){
+				SpeedMultiplier = FMath::Max(SpeedMultiplier, Buff.Magnitude);
+			}
+			break;
+		case EBuffType::EBT_Jump:
+			Buff.TimeRemaining -= DeltaTime;
+			if(Buff.TimeRemaining > 0.f){
+				JumpMultiplier = FMath::Max(JumpMultiplier, Buff.Magnitude);
+			}
+			break;
+		}
+	}
 
-	if(AmountToHeal <= 0.f || Character->GetHealth() >= Character->GetMaxHealth()){
-		bHealing = false;
-		AmountToHeal = 0.f;
+	if(HealThisFrame > 0.f){
+		Character->SetHealth(FMath::Clamp(Character->GetHealth() + HealThisFrame, 0.f, Character->GetMaxHealth()));
+		Character->UpdateHUDHealth();
+	}
+
+	FBuffState NewState = BuffState;
+	NewState.Shield = FMath::Min(NewState.Shield + ShieldThisFrame, MaxShield);
+	NewState.PackedSpeedMultiplier = FBuffState::PackMultiplier(SpeedMultiplier);
+	NewState.PackedJumpMultiplier = FBuffState::PackMultiplier(JumpMultiplier);
+	SetBuffState(NewState);
+
+	//same as the old heal ramp, a heal stops once health is full instead of waiting for a hit to top up again
+	const bool bFullHealth = Character->GetHealth() >= Character->GetMaxHealth();
+	const bool bFullShield = BuffState.Shield >= MaxShield;
+	ActiveBuffs.RemoveAllSwap([bFullHealth, bFullShield](const FActiveBuff& Buff){
+		switch(Buff.Type){
+		case EBuffType::EBT_Heal:
+			return bFullHealth || Buff.Magnitude <= 0.f;
+		case EBuffType::EBT_Shield:
+			return bFullShield || Buff.Magnitude <= 0.f;
+		default:
+			return Buff.TimeRemaining <= 0.f;
+		}
+	});
+
+	SetComponentTickEnabled(ActiveBuffs.Num() > 0);
+}
+
+void UBuffComponent::SetBuffState(const FBuffState& NewState)
+{
+	if(NewState == BuffState) {return;}
+
+	BuffState = NewState;
+	MARK_PROPERTY_DIRTY_FROM_NAME(UBuffComponent, BuffState, this);
+	ApplyMovementBuffs();
+	UpdateHUDShield();
+}
+
+void UBuffComponent::OnRep_BuffState()
+{
+	ApplyMovementBuffs();
+	UpdateHUDShield();
+}
+
+void UBuffComponent::UpdateHUDShield()
+{
+	if(Character == nullptr) {return;}
+
+	Controller = Controller == nullptr ? Cast<ABlasterPlayerController>(Character->Controller) : Controller;
+	if(Controller){
+		Controller->SetHUDShield(BuffState.Shield, MaxShield);
+	}
+}
+
+void UBuffComponent::ApplyMovementBuffs()
+{
+	if(Character == nullptr) {return;}
+
+	if(UBlasterCharacterMovementComponent* Movement = Character->GetBlasterCharacterMovement()){
+		Movement->SetBuffMultipliers(BuffState.GetSpeedMultiplier(), BuffState.GetJumpMultiplier());
 	}
 }
 
@@ -42,6 +206,5 @@ void UBuffComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorC
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
-	HealRampUp(DeltaTime);
+	ProcessBuffs(DeltaTime);
 }
-
@@ -4,35 +4,95 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
+#include "Blaster/BlasterTypes/BuffState.h"
 #include "BuffComponent.generated.h"
 
+enum class EBuffType : uint8
+{
+	EBT_Heal,
+	EBT_Shield,
+	EBT_Speed,
+	EBT_Jump
+};
+
+//one buff a pickup handed out, as the server keeps track of it
+struct FActiveBuff
+{
+	EBuffType Type = EBuffType::EBT_Heal;
+	//heal and shield: points still to add. Speed and jump: the multiplier
+	float Magnitude = 0.f;
+	//heal and shield: points added per second
+	float Rate = 0.f;
+	//speed and jump: seconds until the buff runs out
+	float TimeRemaining = 0.f;
+};
 
+/**
+ * Runs the buffs on a character. The server keeps the active ones in a small array and only ticks while there is
+ * something in it, so a character without buffs costs nothing per frame. What they add up to is replicated in one
+ * FBuffState for clients to apply
+ */
 UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
 class BLASTER_API UBuffComponent : public UActorComponent
 {
 	GENERATED_BODY()
 
-public:	
+public:
 	UBuffComponent();
 	friend class ABlasterCharacter;
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	//every heal and shield pickup adds its own amount on top of any still ramping up
 	void Heal(float HealAmount, float HealingTime);
+	void ReplenishShield(float ShieldAmount, float ReplenishTime);
+
+	//several of these running at once don't multiply, the strongest one applies until the last of them runs out
+	void BuffSpeed(float SpeedMultiplier, float BuffTime);
+	void BuffJump(float JumpMultiplier, float BuffTime);
+
+	//takes as much of Damage as the shield can and returns what is left for health. Server only
+	float AbsorbDamage(float Damage);
+
+	//drops every buff when a recycled character respawns
+	void ResetForRespawn();
+
+	FORCEINLINE float GetShield() const { return BuffState.Shield; }
+	FORCEINLINE float GetMaxShield() const { return MaxShield; }
 
 protected:
 	virtual void BeginPlay() override;
 
-	void HealRampUp(float DeltaTime);
+	void AddBuff(const FActiveBuff& NewBuff);
+	//runs every active buff for DeltaTime and removes the ones that are done
+	void ProcessBuffs(float DeltaTime);
 
 private:
 
 	UPROPERTY()
 	class ABlasterCharacter* Character;
 
-	bool bHealing = false;
-	float HealingRate = 0;
-	float AmountToHeal = 0.f;
+	UPROPERTY()
+	class ABlasterPlayerController* Controller;
+
+	TArray<FActiveBuff, TInlineAllocator<4>> ActiveBuffs;
+
+	UPROPERTY(EditAnywhere, Category = "Buffs")
+	float MaxShield = 100.f;
+
+	UPROPERTY(ReplicatedUsing = OnRep_BuffState)
+	FBuffState BuffState;
+
+	UFUNCTION()
+	void OnRep_BuffState();
+
+	void SetBuffState(const FBuffState& NewState);
+	//hands the speed and jump multipliers to the movement component, on the server and on every client
+	void ApplyMovementBuffs();
+	//only does anything on the machine that controls this character
+	void UpdateHUDShield();
 
 public:
 
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
-		
+
 };
@@ -7,7 +7,9 @@
 #include "Engine/SkeletalMeshSocket.h"
 #include "Components/SphereComponent.h"
 #include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
 #include "GameFramework/CharacterMovementComponent.h"
+#include "BlasterCharacterMovementComponent.h"
 #include "Kismet/GameplayStatics.h"
 #include "Blaster/PlayerController/BlasterPlayerController.h"
 #include "Camera/CameraComponent.h"
@@ -15,13 +17,20 @@
 #include "Sound/SoundCue.h"
 #include "Blaster/Character/BlasterCharacter.h"
 #include "Blaster/Weapon/Projectile.h"
+#include "Blaster/Weapon/ProjectileWeapon.h"
+#include "Blaster/Weapon/ProjectilePoolSubsystem.h"
+#include "Blaster/Blaster.h"
+#include "Blaster/Replication/BlasterReplicationGraph.h"
+#include "Blaster/Character/BlasterSignificanceSubsystem.h"
+#include "Blaster/BlasterComponents/LagCompensationComponent.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Fire Commands Dropped"), STAT_FireCommandsDropped, STATGROUP_Blaster);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Fire Commands Coalesced"), STAT_FireCommandsCoalesced, STATGROUP_Blaster);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Fire Commands Rejected"), STAT_FireCommandsRejected, STATGROUP_Blaster);
 
 UCombatComponent::UCombatComponent()
 {
 	PrimaryComponentTick.bCanEverTick = true;
-
-	BaseWalkSpeed = 600.f;
-	AimWalkSpeed = 450.f;
 }
 
 void UCombatComponent::EquipWeapon(AWeapon *WeaponToEquip)
@@ -32,9 +41,11 @@ void UCombatComponent::EquipWeapon(AWeapon *WeaponToEquip)
 
 	DropEquippedWeapon();
 	EquippedWeapon = WeaponToEquip;
+	MARK_PROPERTY_DIRTY_FROM_NAME(UCombatComponent, EquippedWeapon, this);
 	EquippedWeapon->SetWeaponState(EWeaponState::EWS_Equipped);
 	AttachActorToRightHand(EquippedWeapon);
 	EquippedWeapon->SetOwner(Character);
+	UBlasterReplicationGraph::NotifyWeaponEquipped(Character, EquippedWeapon);
 	EquippedWeapon->SetHUDAmmo();
 	UpdateCarriedAmmo();
 	PlayEquipWeaponSound();
@@ -85,6 +96,7 @@ void UCombatComponent::UpdateCarriedAmmo()
 	if (CarriedAmmoMap.Contains(EquippedWeapon->GetWeaponType()))
 	{
 		CarriedAmmo = CarriedAmmoMap[EquippedWeapon->GetWeaponType()];
+		MARK_PROPERTY_DIRTY_FROM_NAME(UCombatComponent, CarriedAmmo, this);
 	}
 	Controller = Controller == nullptr ? Cast<ABlasterPlayerController>(Character->Controller) : Controller;
 	if (Controller)
@@ -125,6 +137,7 @@ void UCombatComponent::FinishReloading()
 	if(Character == nullptr) {return;}
 	if(Character->HasAuthority()){
 		CombatState = ECombatState::ECS_Unoccupied;
+		MARK_PROPERTY_DIRTY_FROM_NAME(UCombatComponent, CombatState, this);
 		UpdateAmmoValues();
 	}
 	if(bFireButtonPressed){
@@ -155,6 +168,7 @@ void UCombatComponent::ThrowGrenade()
 	if(Grenades == 0) {return;}
 	if (CombatState != ECombatState::ECS_Unoccupied || EquippedWeapon == nullptr) return;
 	CombatState = ECombatState::ECS_ThrowingGrenade;
+	MARK_PROPERTY_DIRTY_FROM_NAME(UCombatComponent, CombatState, this);
 	if (Character)
 	{
 		Character->PlayThrowGrenadeMontage();
@@ -169,6 +183,7 @@ void UCombatComponent::ThrowGrenade()
 	}
 	if(Character && Character->HasAuthority()){
 		Grenades = FMath::Clamp(Grenades - 1, 0, MaxGrenades);
+		MARK_PROPERTY_DIRTY_FROM_NAME(UCombatComponent, Grenades, this);
 		UpdateHUDGrenades();
 	}
 }
@@ -177,6 +192,7 @@ void UCombatComponent::ServerThrowGrenade_Implementation()
 {
 	if(Grenades == 0) {return;}
 	CombatState = ECombatState::ECS_ThrowingGrenade;
+	MARK_PROPERTY_DIRTY_FROM_NAME(UCombatComponent, CombatState, this);
 	if (Character)
 	{
 		Character->PlayThrowGrenadeMontage();
@@ -184,6 +200,7 @@ void UCombatComponent::ServerThrowGrenade_Implementation()
 		ShowAttachedGrenade(true);
 	}
 	Grenades = FMath::Clamp(Grenades - 1, 0, MaxGrenades);
+	MARK_PROPERTY_DIRTY_FROM_NAME(UCombatComponent, Grenades, this);
 	UpdateHUDGrenades();
 }
 
@@ -208,13 +225,21 @@ void UCombatComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty> &Out
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME(UCombatComponent, bAiming);
-	DOREPLIFETIME(UCombatComponent, EquippedWeapon);
+	//everything but the fire ack is push based, so every place that changes one of these has to mark it dirty
+	FDoRepLifetimeParams PushParams;
+	PushParams.bIsPushBased = true;
+	DOREPLIFETIME_WITH_PARAMS_FAST(UCombatComponent, bAiming, PushParams);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UCombatComponent, EquippedWeapon, PushParams);
 	//server will only replicate the CarriedAmmo count to the client that it pertains to, which is the owner
-	DOREPLIFETIME_CONDITION(UCombatComponent, CarriedAmmo, COND_OwnerOnly);
+	FDoRepLifetimeParams OwnerOnlyPushParams;
+	OwnerOnlyPushParams.bIsPushBased = true;
+	OwnerOnlyPushParams.Condition = COND_OwnerOnly;
+	DOREPLIFETIME_WITH_PARAMS_FAST(UCombatComponent, CarriedAmmo, OwnerOnlyPushParams);
 
-	DOREPLIFETIME(UCombatComponent, CombatState);
-	DOREPLIFETIME(UCombatComponent, Grenades);
+	DOREPLIFETIME_CONDITION(UCombatComponent, LastAckedFireSequence, COND_OwnerOnly);
+
+	DOREPLIFETIME_WITH_PARAMS_FAST(UCombatComponent, CombatState, PushParams);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UCombatComponent, Grenades, PushParams);
 }
 
 void UCombatComponent::ShotgunShellReload()
@@ -230,9 +255,9 @@ void UCombatComponent::BeginPlay()
 {
 	Super::BeginPlay();
 
-	if(Character){
-		Character->GetCharacterMovement()->MaxWalkSpeed = BaseWalkSpeed;
+	SeedStream.GenerateNewSeed();
 
+	if(Character){
 		if(Character->GetFollowCamera()){
 			DefaultFOV = Character->GetFollowCamera()->FieldOfView;
 			CurrentFOV = DefaultFOV;
@@ -243,23 +268,27 @@ void UCombatComponent::BeginPlay()
 	}
 }
 
+void UCombatComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	//the HUD outlives this component when the character respawns, so it can't keep looking at our package
+	if(HUD && HUD->GetHUDPackage() == &HUDPackage){
+		HUD->SetHUDPackage(nullptr);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void UCombatComponent::SetAiming(bool bIsAiming)
 {
 	if(Character == nullptr || EquippedWeapon == nullptr) {return;}
 	//this is just "drawing" the client as aiming without waiting for the server to replicate the request back to it. Immediate feedback
 	bAiming = bIsAiming;
+	MARK_PROPERTY_DIRTY_FROM_NAME(UCombatComponent, bAiming, this);
 
-	//SOLUTION 1: for getting the character aim to be replicated across server and client
-	// if(!Character->HasAuthority()){
-	// 	ServerSetAiming(bIsAiming);
-	// }
-
-	//FINAL SOLUTION: see notes as to why with link to reference graph in documentation
-	ServerSetAiming(bIsAiming);
-
-	//this is to set the max walk speed when aiming
-	if(Character){
-		Character->GetCharacterMovement()->MaxWalkSpeed = bIsAiming ? AimWalkSpeed : BaseWalkSpeed;
+	//the aim speed is predicted by the movement component and sent with our moves, so there is no separate RPC to
+	//fall out of step with them
+	if(UBlasterCharacterMovementComponent* BlasterMovement = Character->GetBlasterCharacterMovement()){
+		BlasterMovement->SetWantsToAim(bIsAiming);
 	}
 	if(Character->IsLocallyControlled() && EquippedWeapon->GetWeaponType() == EWeaponType::EWT_SniperRifle){
 		Character->ShowSniperScopeWidget(bAiming);
@@ -279,16 +308,53 @@ void UCombatComponent::PickupAmmo(EWeaponType WeaponType, int32 AmmoAmount)
 	}
 }
 
-void UCombatComponent::ServerSetAiming_Implementation(bool bIsAiming)
+void UCombatComponent::ResetForRespawn()
 {
-	bAiming = bIsAiming;
-
-	//this is to set the max walk speed when aiming on the server so that the server doesn't try to adjust our position
+	bFireButtonPressed = false;
+	CurrentFOV = DefaultFOV;
+	ShowAttachedGrenade(false);
 	if(Character){
-		Character->GetCharacterMovement()->MaxWalkSpeed = bIsAiming ? AimWalkSpeed : BaseWalkSpeed;
+		if(UBlasterCharacterMovementComponent* BlasterMovement = Character->GetBlasterCharacterMovement()){
+			BlasterMovement->SetWantsToAim(false);
+		}
+		Character->GetCharacterMovement()->bOrientRotationToMovement = true;
+		Character->bUseControllerRotationYaw = false;
+		if(Character->GetFollowCamera()){
+			Character->GetFollowCamera()->SetFieldOfView(DefaultFOV);
+		}
+	}
+
+	if(Character == nullptr || !Character->HasAuthority()) {return;}
+
+	//the weapon was already dropped in Elim, we just never let go of the pointer
+	EquippedWeapon = nullptr;
+	MARK_PROPERTY_DIRTY_FROM_NAME(UCombatComponent, EquippedWeapon, this);
+	bAiming = false;
+	MARK_PROPERTY_DIRTY_FROM_NAME(UCombatComponent, bAiming, this);
+	CombatState = ECombatState::ECS_Unoccupied;
+	MARK_PROPERTY_DIRTY_FROM_NAME(UCombatComponent, CombatState, this);
+
+	InitializeCarriedAmmo();
+	CarriedAmmo = 0;
+	MARK_PROPERTY_DIRTY_FROM_NAME(UCombatComponent, CarriedAmmo, this);
+
+	//the archetype holds whatever the blueprint starts a new character with
+	Grenades = CastChecked<UCombatComponent>(GetArchetype())->Grenades;
+	MARK_PROPERTY_DIRTY_FROM_NAME(UCombatComponent, Grenades, this);
+
+	Controller = Controller == nullptr ? Cast<ABlasterPlayerController>(Character->Controller) : Controller;
+	if(Controller){
+		Controller->SetHUDCarriedAmmo(CarriedAmmo);
+		Controller->SetHUDGrenades(Grenades);
 	}
 }
 
+void UCombatComponent::SetAimingFromMove(bool bIsAiming)
+{
+	bAiming = bIsAiming;
+	MARK_PROPERTY_DIRTY_FROM_NAME(UCombatComponent, bAiming, this);
+}
+
 void UCombatComponent::OnRep_EquippedWeapon(){
 	if(EquippedWeapon && Character){
 		
@@ -315,7 +381,34 @@ void UCombatComponent::Fire()
 {
 	if(CanFire()){
 		bCanFire = false;
-		ServerFire(HitTarget);
+		//the tick may have reused an older trace, the shot itself always goes exactly where the crosshair is now
+		if(Character && Character->IsLocallyControlled()){
+			TraceUnderCrosshairs(true);
+		}
+		//one seed per shot is all the other machines need to rebuild the whole spread.
+		//start and target are snapped the way FVector_NetQuantize rounds them on the wire so the shooter traces the same lines
+		const FVector ShotTarget = HitTarget.GridSnap(1.f);
+		FFireCommand FireCommand;
+		FireCommand.Sequence = ++NextFireSequence;
+		FireCommand.HitTarget = ShotTarget;
+		if(Character){
+			Character->RefreshPoseForFiring();
+		}
+		FireCommand.TraceStart = EquippedWeapon ? EquippedWeapon->GetMuzzleLocation().GridSnap(1.f) : ShotTarget;
+		FireCommand.ScatterSeed = EquippedWeapon && EquippedWeapon->UsesFireSeed() ? NextFireSeed() : 0;
+		if(Character && Character->HasAuthority()){
+			ServerProcessFire(FireCommand);
+		}
+		else{
+			//a client fires locally straight away, the server scores it through lag compensation once the batch gets there
+			LocalFire(FireCommand.HitTarget, FireCommand.TraceStart, FireCommand.ScatterSeed);
+			PendingFireCommands.Add(FireCommand);
+			bHasUnsentFireCommands = true;
+			if(PendingFireCommands.Num() > MaxPendingFireCommands){
+				PendingFireCommands.RemoveAt(0);
+				INC_DWORD_STAT(STAT_FireCommandsDropped);
+			}
+		}
 		if(EquippedWeapon){
 			CrosshairShootingFactor = 0.75f;
 		}
@@ -323,32 +416,109 @@ void UCombatComponent::Fire()
 	}
 }
 
-void UCombatComponent::ServerFire_Implementation(const FVector_NetQuantize& TraceHitTarget)
+void UCombatComponent::FlushFireCommands(float DeltaTime)
+{
+	TimeSinceFireFlush += DeltaTime;
+	if(PendingFireCommands.Num() == 0 || Character == nullptr) {return;}
+
+	//one batch per net update of the character, whatever was fired in between rides along in it.
+	//with nothing new to send, the unacknowledged commands are only repeated every FireResendInterval
+	const float FlushInterval = Character->NetUpdateFrequency > 0.f ? 1.f / Character->NetUpdateFrequency : 0.f;
+	if(TimeSinceFireFlush < (bHasUnsentFireCommands ? FlushInterval : FireResendInterval)) {return;}
+	TimeSinceFireFlush = 0.f;
+	bHasUnsentFireCommands = false;
+
+	//anything the server has acknowledged doesn't need to be sent again
+	PendingFireCommands.RemoveAll([this](const FFireCommand& FireCommand){
+		return !IsNewerFireSequence(FireCommand.Sequence, LastAckedFireSequence);
+	});
+	if(PendingFireCommands.Num() > 0){
+		ServerFireBatch(PendingFireCommands);
+	}
+}
+
+void UCombatComponent::ServerFireBatch_Implementation(const TArray<FFireCommand>& FireCommands)
+{
+	//the client never keeps more than this many unacknowledged, so a bigger batch didn't come from our code
+	if(FireCommands.Num() > MaxPendingFireCommands){
+		INC_DWORD_STAT_BY(STAT_FireCommandsRejected, FireCommands.Num());
+		return;
+	}
+
+	int32 NumNew = 0;
+	for(const FFireCommand& FireCommand : FireCommands){
+		//commands we already handled are just the client covering for a lost batch
+		if(!IsNewerFireSequence(FireCommand.Sequence, LastAckedFireSequence)) {continue;}
+
+		//a gap means every batch that carried those shots was lost
+		const uint16 NumSkipped = FireCommand.Sequence - LastAckedFireSequence - 1;
+		INC_DWORD_STAT_BY(STAT_FireCommandsDropped, NumSkipped);
+
+		//a refused shot is still acknowledged, resending it would only get it refused again
+		LastAckedFireSequence = FireCommand.Sequence;
+		if(!CanServerFireCommand()){
+			INC_DWORD_STAT(STAT_FireCommandsRejected);
+			continue;
+		}
+		ServerProcessFire(FireCommand);
+		NumNew++;
+		//a hit scan shot only does damage once its score request comes in, and only a shot accepted here can be scored
+		if(Character->GetLagCompensation()){
+			Character->GetLagCompensation()->AcceptShot(FireCommand, EquippedWeapon);
+		}
+	}
+	if(NumNew > 1){
+		INC_DWORD_STAT_BY(STAT_FireCommandsCoalesced, NumNew - 1);
+	}
+	if(Character && Character->GetLagCompensation()){
+		Character->GetLagCompensation()->ForgetUnacceptedScores(LastAckedFireSequence);
+	}
+}
+
+void UCombatComponent::ServerProcessFire(const FFireCommand& FireCommand)
 {
-	//calling this Multicast RPC will make the server pawn fire and propagate the firing of the weapon to all clients
-	MulticastFire(TraceHitTarget);
+	//the server's own copy of the shot is the one that counts for ammo and damage
+	LocalFire(FireCommand.HitTarget, FireCommand.TraceStart, FireCommand.ScatterSeed);
+	if(Character){
+		Character->NoteCombatActivity();
+	}
+	MulticastFire(FireCommand);
 }
 
-void UCombatComponent::MulticastFire_Implementation(const FVector_NetQuantize& TraceHitTarget){
+void UCombatComponent::MulticastFire_Implementation(const FFireCommand& FireCommand){
+	//the server already fired this shot in ServerProcessFire and the owning client already fired it in Fire
+	if(Character == nullptr || Character->HasAuthority() || Character->IsLocallyControlled()) {return;}
+	if(UBlasterSignificanceSubsystem* SignificanceSubsystem = GetWorld()->GetSubsystem<UBlasterSignificanceSubsystem>()){
+		SignificanceSubsystem->NoteShotFired(Character, FireCommand.HitTarget);
+	}
+	LocalFire(FireCommand.HitTarget, FireCommand.TraceStart, FireCommand.ScatterSeed);
+}
+
+void UCombatComponent::LocalFire(const FVector_NetQuantize& TraceHitTarget, const FVector_NetQuantize& TraceStart, int32 ScatterSeed)
+{
 	//we need to check this since we are wanting to call the fire function on the Weapon class
 	if(EquippedWeapon == nullptr) {return;}
+	if(Character){
+		Character->RefreshPoseForFiring();
+	}
 
 	if (Character && CombatState == ECombatState::ECS_Reloading && EquippedWeapon->GetWeaponType() == EWeaponType::EWT_Shotgun)
 	{
 		Character->PlayFireMontage(bAiming);
-		EquippedWeapon->Fire(TraceHitTarget);
+		EquippedWeapon->FireWithSeed(TraceHitTarget, TraceStart, ScatterSeed);
 		CombatState = ECombatState::ECS_Unoccupied;
+		MARK_PROPERTY_DIRTY_FROM_NAME(UCombatComponent, CombatState, this);
 		return;
 	}
 
 	if(Character && CombatState == ECombatState::ECS_Unoccupied){
 		//bAiming is replicated, so all clients will know if we are aiming or not
 		Character->PlayFireMontage(bAiming);
-		EquippedWeapon->Fire(TraceHitTarget);
+		EquippedWeapon->FireWithSeed(TraceHitTarget, TraceStart, ScatterSeed);
 	}
 }
 
-void UCombatComponent::TraceUnderCrosshairs(FHitResult& TraceHitResult){
+void UCombatComponent::TraceUnderCrosshairs(bool bForceTrace){
 	//this will get the size of the view port so that we can find the middle of the screen
 	FVector2D ViewportSize;
 	if(GEngine && GEngine->GameViewport){
@@ -362,6 +532,14 @@ void UCombatComponent::TraceUnderCrosshairs(FHitResult& TraceHitResult){
 	bool bScreenToWorld = UGameplayStatics::DeprojectScreenToWorld(UGameplayStatics::GetPlayerController(this, 0), CrosshairLocation, OutCrosshairWorldPosition, OutCrosshairWorldDirection);
 
 	if(bScreenToWorld){
+		//the deprojection is cheap, the 80000 unit trace is what we are trying to skip
+		if(!bForceTrace && CanReuseCrosshairTrace(OutCrosshairWorldPosition, OutCrosshairWorldDirection)){
+			return;
+		}
+		LastTraceViewLocation = OutCrosshairWorldPosition;
+		LastTraceViewDirection = OutCrosshairWorldDirection;
+		LastTraceTime = GetWorld()->GetTimeSeconds();
+
 		FVector Start = OutCrosshairWorldPosition;
 
 		if(Character){
@@ -373,6 +551,7 @@ void UCombatComponent::TraceUnderCrosshairs(FHitResult& TraceHitResult){
 
 		FVector End = Start + OutCrosshairWorldDirection * TRACE_LENGTH;
 
+		FHitResult TraceHitResult;
 		GetWorld()->LineTraceSingleByChannel(TraceHitResult, Start, End, ECollisionChannel::ECC_Visibility);
 
 		//if we hit nothing in the hit result, then we will just set the impact point as the End point
@@ -380,8 +559,13 @@ void UCombatComponent::TraceUnderCrosshairs(FHitResult& TraceHitResult){
 		if(!TraceHitResult.bBlockingHit){
 			TraceHitResult.ImpactPoint = End;
 		}
+		HitTarget = TraceHitResult.ImpactPoint;
+
+		AActor* HitActor = TraceHitResult.GetActor();
+		LastTraceHitActor = HitActor;
+		LastTraceHitActorLocation = HitActor ? HitActor->GetActorLocation() : FVector::ZeroVector;
 
-		if(TraceHitResult.GetActor() && TraceHitResult.GetActor()->Implements<UInteractWithCrosshairsInterface>()){
+		if(IsCrosshairInteractable(HitActor)){
 			HUDPackage.CrosshairColor = FLinearColor::Red;
 		}
 		else{
@@ -390,6 +574,35 @@ void UCombatComponent::TraceUnderCrosshairs(FHitResult& TraceHitResult){
 	}
 }
 
+bool UCombatComponent::CanReuseCrosshairTrace(const FVector& ViewLocation, const FVector& ViewDirection) const
+{
+	if(LastTraceTime < 0.f || GetWorld()->GetTimeSeconds() - LastTraceTime > CrosshairTraceMaxAge) {return false;}
+
+	//the view has to be where it was
+	if(FVector::DistSquared(ViewLocation, LastTraceViewLocation) > FMath::Square(CrosshairTraceLocationTolerance)) {return false;}
+	if(FVector::DotProduct(ViewDirection, LastTraceViewDirection) < FMath::Cos(FMath::DegreesToRadians(CrosshairTraceAngleTolerance))) {return false;}
+
+	//and so does whatever we were looking at, a character walking through the crosshair needs a new trace right away
+	if(LastTraceHitActor.IsStale()) {return false;}
+	if(const AActor* HitActor = LastTraceHitActor.Get()){
+		if(FVector::DistSquared(HitActor->GetActorLocation(), LastTraceHitActorLocation) > FMath::Square(CrosshairTraceLocationTolerance)) {return false;}
+	}
+	return true;
+}
+
+bool UCombatComponent::IsCrosshairInteractable(const AActor* Actor)
+{
+	if(Actor == nullptr) {return false;}
+
+	UClass* ActorClass = Actor->GetClass();
+	if(const bool* bCached = CrosshairInteractableClasses.Find(ActorClass)){
+		return *bCached;
+	}
+	const bool bInteractable = ActorClass->ImplementsInterface(UInteractWithCrosshairsInterface::StaticClass());
+	CrosshairInteractableClasses.Add(ActorClass, bInteractable);
+	return bInteractable;
+}
+
 void UCombatComponent::SetHUDCrosshairs(float DeltaTime)
 {
 	if(Character == nullptr || Character->Controller == nullptr){
@@ -421,8 +634,8 @@ void UCombatComponent::SetHUDCrosshairs(float DeltaTime)
 
 			//Calculate crosshair spread
 
-			//map character movement speed [0, 600] to [0, 1]
-			FVector2D WalkSpeedRange(0.f, Character->GetCharacterMovement()->MaxWalkSpeed);
+			//map character movement speed [0, 600] to [0, 1]. GetMaxSpeed is the aim speed while aiming
+			FVector2D WalkSpeedRange(0.f, Character->GetCharacterMovement()->GetMaxSpeed());
 			FVector2D VelocityMultiplierRange(0.f, 1.f);
 			FVector Velocity = Character->GetVelocity();
 			Velocity.Z = 0.f;
@@ -448,7 +661,11 @@ void UCombatComponent::SetHUDCrosshairs(float DeltaTime)
 
 			HUDPackage.CrosshairSpread = 0.5f + CrosshairVelocityFactor + CrosshairInAirFactor - CrosshairAimFactor + CrosshairShootingFactor;
 
-			HUD->SetHUDPackage(HUDPackage);
+			//the HUD reads the package straight from here, so it only needs pointing at it when this character takes the HUD
+			//over, like the first time round or after the player controlled another character
+			if(HUD->GetHUDPackage() != &HUDPackage){
+				HUD->SetHUDPackage(&HUDPackage);
+			}
 		}
 	}
 }
@@ -457,6 +674,7 @@ void UCombatComponent::ServerReload_Implementation()
 {
 	if(Character == nullptr || EquippedWeapon == nullptr) { return; }
 	CombatState = ECombatState::ECS_Reloading;
+	MARK_PROPERTY_DIRTY_FROM_NAME(UCombatComponent, CombatState, this);
 	HandleReload();
 }
 
@@ -502,6 +720,23 @@ void UCombatComponent::FireTimerFinished()
 	ReloadEmptyWeapon();
 }
 
+bool UCombatComponent::CanServerFireCommand()
+{
+	if(EquippedWeapon == nullptr || EquippedWeapon->IsEmpty() || Character == nullptr) {return false;}
+	if(Character->IsElimmed() || Character->GetDisableGameplay()) {return false;}
+
+	//same states CanFire lets the client shoot in. bCanFire isn't checked, the fire timer only runs on the shooter
+	const bool bInterruptsShotgunReload = CombatState == ECombatState::ECS_Reloading && EquippedWeapon->GetWeaponType() == EWeaponType::EWT_Shotgun;
+	if(CombatState != ECombatState::ECS_Unoccupied && !bInterruptsShotgunReload) {return false;}
+
+	//shots fired FireDelay apart can still arrive together in one batch, so a shot may be up to FireRateTolerance
+	//early. Every accepted shot pushes the next allowed time on by a full FireDelay, so the rate can't be beaten
+	const double Now = GetWorld()->GetTimeSeconds();
+	if(Now < NextServerShotTime - FireRateTolerance) {return false;}
+	NextServerShotTime = FMath::Max(NextServerShotTime, Now) + EquippedWeapon->FireDelay;
+	return true;
+}
+
 bool UCombatComponent::CanFire()
 {
     if(EquippedWeapon == nullptr) {return false;}
@@ -566,6 +801,7 @@ void UCombatComponent::UpdateAmmoValues()
 	if(CarriedAmmoMap.Contains(EquippedWeapon->GetWeaponType())){
 		CarriedAmmoMap[EquippedWeapon->GetWeaponType()] -= ReloadAmount;
 		CarriedAmmo = CarriedAmmoMap[EquippedWeapon->GetWeaponType()];
+		MARK_PROPERTY_DIRTY_FROM_NAME(UCombatComponent, CarriedAmmo, this);
 	}
 	Controller = Controller == nullptr ? Cast<ABlasterPlayerController>(Character->Controller) : Controller;
 	if(Controller){
@@ -582,6 +818,7 @@ void UCombatComponent::UpdateShotgunAmmoValues()
 	{
 		CarriedAmmoMap[EquippedWeapon->GetWeaponType()] -= 1;
 		CarriedAmmo = CarriedAmmoMap[EquippedWeapon->GetWeaponType()];
+		MARK_PROPERTY_DIRTY_FROM_NAME(UCombatComponent, CarriedAmmo, this);
 	}
 	Controller = Controller == nullptr ? Cast<ABlasterPlayerController>(Character->Controller) : Controller;
 	if (Controller)
@@ -609,6 +846,7 @@ void UCombatComponent::JumpToShotgunEnd()
 void UCombatComponent::ThrowGrenadeFinished()
 {
 	CombatState = ECombatState::ECS_Unoccupied;
+	MARK_PROPERTY_DIRTY_FROM_NAME(UCombatComponent, CombatState, this);
 	AttachActorToRightHand(EquippedWeapon);
 }
 
@@ -617,26 +855,80 @@ void UCombatComponent::LaunchGrenade()
 	ShowAttachedGrenade(false);
 	if (Character && Character->IsLocallyControlled())
 	{
-		ServerLaunchGrenade(HitTarget);
+		const int32 ShotId = NextShotId();
+		//the throwing client sees its grenade leave the hand right away
+		if (!Character->HasAuthority() && GrenadeClass && Character->GetAttachedGrenade())
+		{
+			//the mesh is hidden when the camera gets close, so the hand may not have been posed this frame
+			Character->RefreshPoseForFiring();
+			const FVector StartingLocation = Character->GetAttachedGrenade()->GetComponentLocation();
+			SpawnPredictedProjectile(GrenadeClass, StartingLocation, (HitTarget - StartingLocation).Rotation(), ShotId);
+		}
+		ServerLaunchGrenade(HitTarget, ShotId);
 	}
 }
 
-void UCombatComponent::ServerLaunchGrenade_Implementation(const FVector_NetQuantize & Target)
+void UCombatComponent::ServerLaunchGrenade_Implementation(const FVector_NetQuantize & Target, int32 ShotId)
 {
 	if(Character && GrenadeClass && Character->GetAttachedGrenade()){
 		const FVector StartingLocation = Character->GetAttachedGrenade()->GetComponentLocation();
 		FVector ToTarget = Target - StartingLocation;
-		FActorSpawnParameters SpawnParams;
-		SpawnParams.Owner = Character;
-		SpawnParams.Instigator = Character;
 		UWorld* World = GetWorld();
-		if (World)
+		UProjectilePoolSubsystem* ProjectilePool = World ? World->GetSubsystem<UProjectilePoolSubsystem>() : nullptr;
+		AProjectile* Grenade = ProjectilePool ? ProjectilePool->AcquireProjectile(GrenadeClass, StartingLocation, ToTarget.Rotation(), Character, Character) : nullptr;
+		if (Grenade)
 		{
-			World->SpawnActor<AProjectile>(GrenadeClass, StartingLocation, ToTarget.Rotation(), SpawnParams);
+			Grenade->SetShotId(ShotId);
 		}
 	}
 }
 
+void UCombatComponent::SpawnPredictedProjectile(TSubclassOf<AProjectile> ProjectileClass, const FVector& Location, const FRotator& Rotation, int32 ShotId)
+{
+	UWorld* World = GetWorld();
+	if(World == nullptr || ProjectileClass == nullptr || Character == nullptr) {return;}
+
+	//anything that was never matched and has since cleaned itself up can go
+	for(auto It = PredictedProjectiles.CreateIterator(); It; ++It){
+		if(!It.Value().IsValid()){
+			It.RemoveCurrent();
+		}
+	}
+
+	//this actor only exists on this client. It is never replicated, so it is never confused with the server copy
+	AProjectile* Projectile = World->SpawnActorDeferred<AProjectile>(ProjectileClass, FTransform(Rotation, Location), Character, Character, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+	if(Projectile){
+		Projectile->MarkCosmeticOnly(ShotId);
+		Projectile->SetReplicates(false);
+		Projectile->FinishSpawning(FTransform(Rotation, Location));
+		Projectile->SetLifeSpan(PredictedProjectileLifeSpan);
+		PredictedProjectiles.Add(ShotId, Projectile);
+	}
+}
+
+AProjectile* UCombatComponent::TakePredictedProjectile(int32 ShotId)
+{
+	TWeakObjectPtr<AProjectile> Projectile;
+	PredictedProjectiles.RemoveAndCopyValue(ShotId, Projectile);
+	return Projectile.Get();
+}
+
+int32 UCombatComponent::NextShotId()
+{
+	//0 is a shot without a seed, so the id skips it when it wraps around
+	LastShotId = LastShotId == MAX_int32 ? 1 : LastShotId + 1;
+	return LastShotId;
+}
+
+int32 UCombatComponent::NextFireSeed()
+{
+	if(Cast<AProjectileWeapon>(EquippedWeapon)){
+		return NextShotId();
+	}
+	const int32 Seed = static_cast<int32>(SeedStream.GetUnsignedInt());
+	return Seed != 0 ? Seed : 1;
+}
+
 void UCombatComponent::OnRep_Grenades()
 {
 	UpdateHUDGrenades();
@@ -649,12 +941,14 @@ void UCombatComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActo
 
 	//we are doing this for drawing debug lines to see how far off our muzzle is from being on target
 	if(Character && Character->IsLocallyControlled()){
-		FHitResult HitResult;
-		TraceUnderCrosshairs(HitResult);
-		HitTarget = HitResult.ImpactPoint;
+		TraceUnderCrosshairs();
 
 		SetHUDCrosshairs(DeltaTime);
 		InterpFOV(DeltaTime);
+
+		if(!Character->HasAuthority()){
+			FlushFireCommands(DeltaTime);
+		}
 	}
 }
 
@@ -4,9 +4,11 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
+#include "UObject/ObjectKey.h"
 #include "Blaster/HUD/BlasterHUD.h"
 #include "Blaster/Weapon/WeaponTypes.h"
 #include "Blaster/BlasterTypes/CombatState.h"
+#include "Blaster/BlasterTypes/FireCommand.h"
 #include "CombatComponent.generated.h"
 
 class AWeapon;
@@ -46,35 +48,67 @@ public:
 	UFUNCTION(BlueprintCallable)
 	void LaunchGrenade();
 
+	//ShotId matches the grenade the server spawns with the one the throwing client predicted
 	UFUNCTION(Server, Reliable)
-	void ServerLaunchGrenade(const FVector_NetQuantize& Target);
+	void ServerLaunchGrenade(const FVector_NetQuantize& Target, int32 ShotId);
 
 	FORCEINLINE int32 GetGrenades() const { return Grenades; }
+	FORCEINLINE TSubclassOf<class AProjectile> GetGrenadeClass() const { return GrenadeClass; }
 
 	void PickupAmmo(EWeaponType WeaponType, int32 AmmoAmount);
 
+	//the server picked up a change of aim from a client's move, so everyone else gets told through bAiming
+	void SetAimingFromMove(bool bIsAiming);
+
+	//puts a recycled character's combat state back to how a freshly spawned character starts. Runs on every machine
+	void ResetForRespawn();
+
+	/**
+	 * Predicted projectiles
+	 */
+
+	//spawns the owning client's local copy of a projectile shot, which is kept until the server copy with the same ShotId shows up
+	void SpawnPredictedProjectile(TSubclassOf<class AProjectile> ProjectileClass, const FVector& Location, const FRotator& Rotation, int32 ShotId);
+	//hands over the predicted copy for ShotId, if there still is one, and forgets about it
+	AProjectile* TakePredictedProjectile(int32 ShotId);
+
+	//the fire command sequence of the newest shot. While a weapon fires on the shooting client it is that shot's, which
+	//is how a score request names the shot it scores
+	FORCEINLINE uint16 GetLastFireSequence() const { return NextFireSequence; }
+	FORCEINLINE uint16 GetLastAckedFireSequence() const { return LastAckedFireSequence; }
+
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
-	//this is called from the character class to tell the server to propagate aiming across server and clients
+	//this is called from the character class when the aim button changes. The movement component carries it to the server
 	void SetAiming(bool bIsAiming);
 
-	//this is our RPC for aiming and we will use the input parameter
-	UFUNCTION(Server, Reliable)
-	void ServerSetAiming(bool bIsAiming);
-
 	UFUNCTION()
 	void OnRep_EquippedWeapon();
 
 	void Fire();
 
-	UFUNCTION(Server, Reliable)
-	void ServerFire(const FVector_NetQuantize& TraceHitTarget);
+	//every fire command the server hasn't acknowledged yet, so a lost batch is covered by the next one
+	UFUNCTION(Server, Unreliable)
+	void ServerFireBatch(const TArray<FFireCommand>& FireCommands);
+
+	//runs one shot on the server, which is where ammo and damage are decided
+	void ServerProcessFire(const FFireCommand& FireCommand);
 
-	UFUNCTION(NetMulticast, Reliable)
-	void MulticastFire(const FVector_NetQuantize& TraceHitTarget);
+	//purely cosmetic for everyone but the shooter and the server, so losing one just means a missing muzzle flash
+	UFUNCTION(NetMulticast, Unreliable)
+	void MulticastFire(const FFireCommand& FireCommand);
 
-	void TraceUnderCrosshairs(FHitResult& TraceHitResult);
+	//plays the shot on this machine. The owning client calls this right away so hit scan weapons trace what it sees
+	void LocalFire(const FVector_NetQuantize& TraceHitTarget, const FVector_NetQuantize& TraceStart, int32 ScatterSeed);
+
+	//updates HitTarget and the crosshair color. Reuses the last trace while the view and whatever it hit have barely
+	//moved, bForceTrace always traces, which firing uses so the shot goes exactly where the crosshair is
+	void TraceUnderCrosshairs(bool bForceTrace = false);
+
+	bool CanReuseCrosshairTrace(const FVector& ViewLocation, const FVector& ViewDirection) const;
+	bool IsCrosshairInteractable(const AActor* Actor);
 
 	void SetHUDCrosshairs(float DeltaTime);
 
@@ -93,6 +127,22 @@ protected:
 	UPROPERTY(EditAnywhere)
 	TSubclassOf<class AProjectile> GrenadeClass;
 
+	//predicted copies that have not been matched with a server copy yet, keyed by shot id
+	TMap<int32, TWeakObjectPtr<AProjectile>> PredictedProjectiles;
+
+	//shot ids count up per component, so no two shots still waiting for their server copy can share one
+	int32 LastShotId = 0;
+	int32 NextShotId();
+
+	//scatter seeds come from here instead of FMath::Rand, which only has 15 bits on some platforms
+	FRandomStream SeedStream;
+	//the seed that goes with a shot of the equipped weapon. Projectile weapons send their shot id in its place
+	int32 NextFireSeed();
+
+	//a predicted copy that never gets a server copy, like a shot the server refused, cleans itself up after this long
+	UPROPERTY(EditAnywhere, Category = "Projectile Prediction")
+	float PredictedProjectileLifeSpan = 5.f;
+
 	void DropEquippedWeapon();
 	void AttachActorToRightHand(AActor* ActorToAttach);
 	void AttachActorToLeftHand(AActor* ActorToAttach);
@@ -116,12 +166,6 @@ private:
 	UPROPERTY(Replicated)
 	bool bAiming;
 
-	UPROPERTY(EditAnywhere)
-	float BaseWalkSpeed;
-
-	UPROPERTY(EditAnywhere)
-	float AimWalkSpeed;
-
 	bool bFireButtonPressed;
 
 	/**
@@ -136,6 +180,31 @@ private:
 	FVector HitTarget;
 	FHUDPackage HUDPackage;
 
+	/**
+	 * Crosshair trace cache
+	 */
+
+	FVector LastTraceViewLocation = FVector::ZeroVector;
+	FVector LastTraceViewDirection = FVector::ZeroVector;
+	float LastTraceTime = -1.f;
+	TWeakObjectPtr<AActor> LastTraceHitActor;
+	FVector LastTraceHitActorLocation = FVector::ZeroVector;
+
+	//whether actors of a class implement UInteractWithCrosshairsInterface, looked up once per class
+	TMap<TObjectKey<UClass>, bool> CrosshairInteractableClasses;
+
+	//how far the camera can move in cm before the crosshair is traced again
+	UPROPERTY(EditAnywhere, Category = Crosshairs)
+	float CrosshairTraceLocationTolerance = 1.f;
+
+	//how far the camera can turn in degrees before the crosshair is traced again
+	UPROPERTY(EditAnywhere, Category = Crosshairs)
+	float CrosshairTraceAngleTolerance = 0.1f;
+
+	//a reused trace is thrown away after this long anyway, in case something moved into the line
+	UPROPERTY(EditAnywhere, Category = Crosshairs)
+	float CrosshairTraceMaxAge = 0.1f;
+
 	/**
 	 * Aiming and FOV
 	 */
@@ -160,6 +229,39 @@ private:
 	FTimerHandle FireTimer;
 	bool bCanFire = true;
 
+	/**
+	 * Fire batching
+	 * The shooting client queues its shots as fire commands and sends everything the server hasn't acknowledged once per
+	 * net update. The server acknowledges the newest sequence it has handled through LastAckedFireSequence
+	 */
+
+	void FlushFireCommands(float DeltaTime);
+
+	TArray<FFireCommand> PendingFireCommands;
+	uint16 NextFireSequence = 0;
+	float TimeSinceFireFlush = 0.f;
+	bool bHasUnsentFireCommands = false;
+
+	//how often unacknowledged commands are sent again when there is nothing new to send, roughly a round trip
+	UPROPERTY(EditAnywhere, Category = "Fire Batching")
+	float FireResendInterval = 0.1f;
+
+	//the oldest unacknowledged commands are thrown away past this, which only happens if the server stops answering
+	UPROPERTY(EditAnywhere, Category = "Fire Batching")
+	int32 MaxPendingFireCommands = 16;
+
+	UPROPERTY(Replicated)
+	uint16 LastAckedFireSequence = 0;
+
+	//how early a client's shot may arrive compared to the weapon's fire rate, which should cover one batch and some jitter
+	UPROPERTY(EditAnywhere, Category = "Fire Batching")
+	float FireRateTolerance = 0.2f;
+
+	double NextServerShotTime = 0.0;
+
+	//the server's check of a shot a client sent, state, ammo and fire rate. Only call it once per shot
+	bool CanServerFireCommand();
+
 	void StartFireTimer();
 	void FireTimerFinished();
 
@@ -0,0 +1,352 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "LagCompensationComponent.h"
+#include "Blaster/Character/BlasterCharacter.h"
+#include "Blaster/Weapon/HitScanWeapon.h"
+#include "Blaster/Weapon/Shotgun.h"
+#include "Blaster/BlasterComponents/CombatComponent.h"
+#include "Blaster/Blaster.h"
+#include "Components/BoxComponent.h"
+#include "Kismet/GameplayStatics.h"
+#include "Engine/NetConnection.h"
+
+ULagCompensationComponent::ULagCompensationComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	//we want the boxes after animation has moved them for this frame
+	PrimaryComponentTick.TickGroup = TG_PostUpdateWork;
+}
+
+void ULagCompensationComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	//only the server keeps a history, clients never rewind anything
+	if(Character && Character->HasAuthority()){
+		InitializeHistory();
+	}
+	else{
+		SetComponentTickEnabled(false);
+	}
+}
+
+void ULagCompensationComponent::InitializeHistory()
+{
+	HitBoxes = Character->GetHitBoxes();
+	NumBoxes = HitBoxes.Num();
+	MaxFrames = FMath::Max(2, FMath::CeilToInt(MaxRecordTime * RecordFrequency));
+
+	FrameTimes.SetNumZeroed(MaxFrames);
+	FrameLocations.SetNumZeroed(MaxFrames * NumBoxes);
+	FrameRotations.SetNumZeroed(MaxFrames * NumBoxes);
+	SavedRelativeLocations.SetNumZeroed(NumBoxes);
+	SavedRelativeRotations.SetNumZeroed(NumBoxes);
+
+	ClearHistory();
+}
+
+void ULagCompensationComponent::ClearHistory()
+{
+	Head = 0;
+	NumFrames = 0;
+	LastRecordTime = -1.f;
+}
+
+void ULagCompensationComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	//on the server GetWorld()->GetTimeSeconds() is the same clock that ABlasterPlayerController::GetServerTime reports
+	const float ServerTime = GetWorld()->GetTimeSeconds();
+	if(LastRecordTime >= 0.f && ServerTime - LastRecordTime < 1.f / RecordFrequency){
+		return;
+	}
+	RecordFrame(ServerTime);
+}
+
+void ULagCompensationComponent::RecordFrame(float Time)
+{
+	if(NumBoxes == 0 || MaxFrames == 0) {return;}
+
+	FrameTimes[Head] = Time;
+	const int32 Base = Head * NumBoxes;
+	for(int32 Box = 0; Box < NumBoxes; ++Box){
+		const UBoxComponent* HitBox = HitBoxes[Box];
+		if(HitBox){
+			FrameLocations[Base + Box] = FVector3f(HitBox->GetComponentLocation());
+			FrameRotations[Base + Box] = FQuat4f(HitBox->GetComponentQuat());
+		}
+	}
+
+	Head = (Head + 1) % MaxFrames;
+	NumFrames = FMath::Min(NumFrames + 1, MaxFrames);
+	LastRecordTime = Time;
+}
+
+void ULagCompensationComponent::RewindHitBoxes(float Time)
+{
+	if(bRewound) {return;}
+	bRewound = true;
+
+	for(int32 Box = 0; Box < NumBoxes; ++Box){
+		UBoxComponent* HitBox = HitBoxes[Box];
+		if(HitBox){
+			SavedRelativeLocations[Box] = HitBox->GetRelativeLocation();
+			SavedRelativeRotations[Box] = HitBox->GetRelativeRotation();
+			HitBox->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+		}
+	}
+
+	//nothing recorded yet, so the current pose is the best guess we have
+	if(NumFrames == 0) {return;}
+
+	//binary search for the first frame at or after Time. Frame times only ever increase from oldest to newest
+	int32 Low = 0;
+	int32 High = NumFrames;
+	while(Low < High){
+		const int32 Mid = (Low + High) / 2;
+		if(FrameTimes[FrameIndex(Mid)] < Time){
+			Low = Mid + 1;
+		}
+		else{
+			High = Mid;
+		}
+	}
+
+	//anything older than the history gets the oldest frame and anything newer gets the newest frame
+	const int32 Younger = FrameIndex(FMath::Clamp(Low, 0, NumFrames - 1));
+	const int32 Older = FrameIndex(FMath::Clamp(Low - 1, 0, NumFrames - 1));
+	const float OlderTime = FrameTimes[Older];
+	const float YoungerTime = FrameTimes[Younger];
+	const float Alpha = YoungerTime > OlderTime ? FMath::Clamp((Time - OlderTime) / (YoungerTime - OlderTime), 0.f, 1.f) : 1.f;
+
+	const int32 OlderBase = Older * NumBoxes;
+	const int32 YoungerBase = Younger * NumBoxes;
+	for(int32 Box = 0; Box < NumBoxes; ++Box){
+		UBoxComponent* HitBox = HitBoxes[Box];
+		if(HitBox){
+			const FVector3f Location = FMath::Lerp(FrameLocations[OlderBase + Box], FrameLocations[YoungerBase + Box], Alpha);
+			const FQuat4f Rotation = FQuat4f::Slerp(FrameRotations[OlderBase + Box], FrameRotations[YoungerBase + Box], Alpha);
+			HitBox->SetWorldLocationAndRotation(FVector(Location), FQuat(Rotation));
+		}
+	}
+}
+
+void ULagCompensationComponent::RestoreHitBoxes()
+{
+	if(!bRewound) {return;}
+	bRewound = false;
+
+	for(int32 Box = 0; Box < NumBoxes; ++Box){
+		UBoxComponent* HitBox = HitBoxes[Box];
+		if(HitBox){
+			HitBox->SetRelativeLocationAndRotation(SavedRelativeLocations[Box], SavedRelativeRotations[Box]);
+			HitBox->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		}
+	}
+}
+
+bool ULagCompensationComponent::ConfirmHit(ABlasterCharacter* HitCharacter, const FVector& TraceStart, const FVector& HitLocation, float HitTime)
+{
+	if(HitCharacter == nullptr || HitCharacter->GetLagCompensation() == nullptr) {return false;}
+	UWorld* World = GetWorld();
+	if(World == nullptr) {return false;}
+
+	ULagCompensationComponent* TargetLagCompensation = HitCharacter->GetLagCompensation();
+	TargetLagCompensation->RewindHitBoxes(HitTime);
+
+	//extend past the reported hit location so a hit right on the surface of a box still registers
+	const FVector TraceEnd = TraceStart + (HitLocation - TraceStart) * 1.25f;
+	FHitResult ConfirmHitResult;
+	World->LineTraceSingleByChannel(ConfirmHitResult, TraceStart, TraceEnd, ECC_HitBox);
+	const bool bHitConfirmed = ConfirmHitResult.bBlockingHit && ConfirmHitResult.GetActor() == HitCharacter;
+
+	TargetLagCompensation->RestoreHitBoxes();
+	return bHitConfirmed;
+}
+
+void ULagCompensationComponent::ConfirmShotgunHits(const TArray<ABlasterCharacter*>& HitCharacters, const FVector& TraceStart, const TArray<FVector>& TraceEnds, float HitTime, TMap<ABlasterCharacter*, uint32>& OutHitCounts)
+{
+	UWorld* World = GetWorld();
+	if(World == nullptr) {return;}
+
+	//every character gets rewound at once so a pellet can still be blocked by someone standing in front of its target
+	for(ABlasterCharacter* HitCharacter : HitCharacters){
+		if(HitCharacter && HitCharacter->GetLagCompensation()){
+			HitCharacter->GetLagCompensation()->RewindHitBoxes(HitTime);
+		}
+	}
+
+	for(const FVector& TraceEnd : TraceEnds){
+		FHitResult ConfirmHitResult;
+		World->LineTraceSingleByChannel(ConfirmHitResult, TraceStart, TraceEnd, ECC_HitBox);
+
+		ABlasterCharacter* BlasterCharacter = Cast<ABlasterCharacter>(ConfirmHitResult.GetActor());
+		if(BlasterCharacter && HitCharacters.Contains(BlasterCharacter)){
+			OutHitCounts.FindOrAdd(BlasterCharacter)++;
+		}
+	}
+
+	for(ABlasterCharacter* HitCharacter : HitCharacters){
+		if(HitCharacter && HitCharacter->GetLagCompensation()){
+			HitCharacter->GetLagCompensation()->RestoreHitBoxes();
+		}
+	}
+}
+
+void ULagCompensationComponent::ServerScoreRequest_Implementation(ABlasterCharacter* HitCharacter, const FVector_NetQuantize& HitLocation, uint16 FireSequence, float HitTime)
+{
+	if(HitCharacter == nullptr || !IsHitTimeValid(HitTime)) {return;}
+
+	FPendingScoreRequest Request;
+	Request.Sequence = FireSequence;
+	Request.HitTime = HitTime;
+	Request.HitLocation = HitLocation;
+	Request.HitCharacters.Add(HitCharacter);
+	HandleScoreRequest(Request);
+}
+
+void ULagCompensationComponent::ShotgunServerScoreRequest_Implementation(const TArray<ABlasterCharacter*>& HitCharacters, uint16 FireSequence, float HitTime)
+{
+	if(HitCharacters.Num() == 0 || !IsHitTimeValid(HitTime)) {return;}
+
+	FPendingScoreRequest Request;
+	Request.Sequence = FireSequence;
+	Request.HitTime = HitTime;
+	for(ABlasterCharacter* HitCharacter : HitCharacters){
+		if(HitCharacter){
+			Request.HitCharacters.AddUnique(HitCharacter);
+		}
+	}
+	HandleScoreRequest(Request);
+}
+
+void ULagCompensationComponent::HandleScoreRequest(const FPendingScoreRequest& Request)
+{
+	const int32 ShotIndex = AcceptedShots.IndexOfByPredicate([&Request](const FAcceptedShot& Shot){ return Shot.Sequence == Request.Sequence; });
+	if(ShotIndex != INDEX_NONE){
+		const FAcceptedShot Shot = AcceptedShots[ShotIndex];
+		AcceptedShots.RemoveAt(ShotIndex);
+		//a shot accepted long ago can't be the one the client just hit with
+		if(GetWorld()->GetTimeSeconds() - Shot.AcceptedTime <= GetMaxShotAge()){
+			ScoreShot(Shot, Request);
+		}
+		return;
+	}
+
+	//the client sends the score request as it fires and the shot only goes up with its next fire batch, so the request
+	//usually gets here first and waits. A shot the server has already handled and didn't accept is never scored
+	UCombatComponent* Combat = Character ? Character->GetCombat() : nullptr;
+	if(Combat == nullptr || !IsNewerFireSequence(Request.Sequence, Combat->GetLastAckedFireSequence())) {return;}
+	if(PendingScores.ContainsByPredicate([&Request](const FPendingScoreRequest& Pending){ return Pending.Sequence == Request.Sequence; })) {return;}
+
+	if(PendingScores.Num() >= MaxUnscoredShots){
+		PendingScores.RemoveAt(0);
+	}
+	PendingScores.Add(Request);
+}
+
+void ULagCompensationComponent::AcceptShot(const FFireCommand& FireCommand, AWeapon* Weapon)
+{
+	//projectiles do their own damage on the server and a hit scan weapon without rewind is scored by the server's trace
+	const AHitScanWeapon* HitScanWeapon = Cast<AHitScanWeapon>(Weapon);
+	if(HitScanWeapon == nullptr || !HitScanWeapon->UsesServerSideRewind()) {return;}
+
+	FAcceptedShot Shot;
+	Shot.Sequence = FireCommand.Sequence;
+	Shot.TraceStart = FireCommand.TraceStart;
+	Shot.HitTarget = FireCommand.HitTarget;
+	Shot.ScatterSeed = FireCommand.ScatterSeed;
+	Shot.Weapon = Weapon;
+	Shot.AcceptedTime = GetWorld()->GetTimeSeconds();
+
+	const int32 RequestIndex = PendingScores.IndexOfByPredicate([&Shot](const FPendingScoreRequest& Pending){ return Pending.Sequence == Shot.Sequence; });
+	if(RequestIndex != INDEX_NONE){
+		const FPendingScoreRequest Request = PendingScores[RequestIndex];
+		PendingScores.RemoveAt(RequestIndex);
+		ScoreShot(Shot, Request);
+		return;
+	}
+
+	if(AcceptedShots.Num() >= MaxUnscoredShots){
+		AcceptedShots.RemoveAt(0);
+	}
+	AcceptedShots.Add(Shot);
+}
+
+void ULagCompensationComponent::ForgetUnacceptedScores(uint16 LastHandledSequence)
+{
+	PendingScores.RemoveAll([LastHandledSequence](const FPendingScoreRequest& Pending){
+		return !IsNewerFireSequence(Pending.Sequence, LastHandledSequence);
+	});
+}
+
+void ULagCompensationComponent::ScoreShot(const FAcceptedShot& Shot, const FPendingScoreRequest& Request)
+{
+	//only the weapon this character is actually holding is allowed to score
+	AWeapon* Weapon = Shot.Weapon.Get();
+	if(Character == nullptr || Weapon == nullptr || Weapon != Character->GetEquippedWeapon()) {return;}
+	if(!IsTraceStartValid(Shot.TraceStart, Weapon, Request.HitTime)) {return;}
+
+	if(AShotgun* Shotgun = Cast<AShotgun>(Weapon)){
+		//no more characters than pellets can have been hit
+		if(Request.HitCharacters.Num() > static_cast<int32>(Shotgun->GetNumberOfPellets())) {return;}
+		TArray<ABlasterCharacter*> HitCharacters;
+		for(const TWeakObjectPtr<ABlasterCharacter>& HitCharacter : Request.HitCharacters){
+			if(HitCharacter.IsValid()){
+				HitCharacters.Add(HitCharacter.Get());
+			}
+		}
+
+		//same seed, same pellets the client traced
+		TArray<FVector> TraceEnds;
+		Shotgun->TraceEndsWithScatter(Shot.TraceStart, Shot.HitTarget, Shot.ScatterSeed, Shotgun->GetNumberOfPellets(), TraceEnds);
+
+		TMap<ABlasterCharacter*, uint32> HitCounts;
+		ConfirmShotgunHits(HitCharacters, Shot.TraceStart, TraceEnds, Request.HitTime, HitCounts);
+
+		for(const TPair<ABlasterCharacter*, uint32>& HitPair : HitCounts){
+			UGameplayStatics::ApplyDamage(HitPair.Key, Shotgun->GetDamage() * HitPair.Value, Character->Controller, Shotgun, UDamageType::StaticClass());
+		}
+	}
+	else if(AHitScanWeapon* HitScanWeapon = Cast<AHitScanWeapon>(Weapon)){
+		ABlasterCharacter* HitCharacter = Request.HitCharacters.Num() > 0 ? Request.HitCharacters[0].Get() : nullptr;
+		if(ConfirmHit(HitCharacter, Shot.TraceStart, Request.HitLocation, Request.HitTime)){
+			UGameplayStatics::ApplyDamage(HitCharacter, HitScanWeapon->GetDamage(), Character->Controller, HitScanWeapon, UDamageType::StaticClass());
+		}
+	}
+}
+
+float ULagCompensationComponent::GetMaxShotAge() const
+{
+	const UNetConnection* Connection = Character ? Character->GetNetConnection() : nullptr;
+	const float RoundTripTime = Connection ? Connection->AvgLag : 0.f;
+	return FMath::Min(RoundTripTime + HitTimeMargin, MaxRecordTime);
+}
+
+bool ULagCompensationComponent::IsHitTimeValid(float HitTime) const
+{
+	UWorld* World = GetWorld();
+	if(World == nullptr || Character == nullptr) {return false;}
+
+	//an honest HitTime is one trip behind the client's server clock and the request spends another trip getting here,
+	//so it is never in the future and never much older than a round trip
+	const float Age = World->GetTimeSeconds() - HitTime;
+	return Age >= 0.f && Age <= GetMaxShotAge();
+}
+
+bool ULagCompensationComponent::IsTraceStartValid(const FVector& TraceStart, const AWeapon* Weapon, float HitTime) const
+{
+	UWorld* World = GetWorld();
+	if(World == nullptr || Character == nullptr || Weapon == nullptr) {return false;}
+
+	//the muzzle is only where the client saw it if the pose is up to date, which off screen characters skip
+	Character->RefreshPoseForFiring();
+
+	//HitTime is roughly one trip before the client fired, so the character can have moved for about a round trip since.
+	//IsHitTimeValid has already held that to a round trip and HitTimeMargin
+	const float TimeSinceShot = FMath::Max(World->GetTimeSeconds() - HitTime, 0.f);
+	const float Tolerance = MaxTraceStartError + Character->GetVelocity().Size() * TimeSinceShot;
+	return FVector::DistSquared(TraceStart, Weapon->GetMuzzleLocation()) <= FMath::Square(Tolerance);
+}
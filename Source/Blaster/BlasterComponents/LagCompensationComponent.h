@@ -0,0 +1,152 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Blaster/BlasterTypes/FireCommand.h"
+#include "LagCompensationComponent.generated.h"
+
+class ABlasterCharacter;
+class AWeapon;
+
+//a hit scan shot the server accepted from one of this character's fire batches, waiting for its score request
+struct FAcceptedShot
+{
+	uint16 Sequence = 0;
+	FVector TraceStart = FVector::ZeroVector;
+	FVector HitTarget = FVector::ZeroVector;
+	int32 ScatterSeed = 0;
+	TWeakObjectPtr<AWeapon> Weapon;
+	float AcceptedTime = 0.f;
+};
+
+//what a score request asks for. It waits here if it gets to the server before the fire batch carrying its shot
+struct FPendingScoreRequest
+{
+	uint16 Sequence = 0;
+	float HitTime = 0.f;
+	//hit scan only, shotgun pellets are rebuilt from the accepted shot
+	FVector HitLocation = FVector::ZeroVector;
+	TArray<TWeakObjectPtr<ABlasterCharacter>, TInlineAllocator<4>> HitCharacters;
+};
+
+/**
+ * Server-side rewind. The server records where every hit box of this character was over the last few seconds, and a
+ * shooting client can ask the server to check its hit against the hit boxes as they were when that client fired
+ */
+UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
+class BLASTER_API ULagCompensationComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	ULagCompensationComponent();
+
+	friend class ABlasterCharacter;
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	//sent by the shooting client for a hit scan hit. FireSequence is the fire command of the shot, the trace start and
+	//weapon come from the server's copy of it. HitTime is the server time the client was seeing when it fired
+	UFUNCTION(Server, Reliable)
+	void ServerScoreRequest(ABlasterCharacter* HitCharacter, const FVector_NetQuantize& HitLocation, uint16 FireSequence, float HitTime);
+
+	//same as above for a shotgun blast. The server rebuilds the pellets from the accepted shot instead of being sent every pellet
+	UFUNCTION(Server, Reliable)
+	void ShotgunServerScoreRequest(const TArray<ABlasterCharacter*>& HitCharacters, uint16 FireSequence, float HitTime);
+
+	//the combat component hands over every client shot it accepts. Each one can be scored once and nothing else can be
+	void AcceptShot(const FFireCommand& FireCommand, AWeapon* Weapon);
+	//drops score requests still waiting on a shot up to LastHandledSequence, which was either refused or never arrived
+	void ForgetUnacceptedScores(uint16 LastHandledSequence);
+
+	bool ConfirmHit(ABlasterCharacter* HitCharacter, const FVector& TraceStart, const FVector& HitLocation, float HitTime);
+	void ConfirmShotgunHits(const TArray<ABlasterCharacter*>& HitCharacters, const FVector& TraceStart, const TArray<FVector>& TraceEnds, float HitTime, TMap<ABlasterCharacter*, uint32>& OutHitCounts);
+
+	//moves this character's hit boxes to where they were at Time and turns on their collision so they can be traced against
+	void RewindHitBoxes(float Time);
+	//puts the hit boxes back where the animation has them and turns their collision back off
+	void RestoreHitBoxes();
+
+	void ClearHistory();
+
+protected:
+	virtual void BeginPlay() override;
+
+private:
+
+	UPROPERTY()
+	ABlasterCharacter* Character;
+
+	UPROPERTY()
+	TArray<class UBoxComponent*> HitBoxes;
+
+	void InitializeHistory();
+	void RecordFrame(float Time);
+
+	//scores a shot with the first score request for it, whichever of the two got here last
+	void ScoreShot(const FAcceptedShot& Shot, const FPendingScoreRequest& Request);
+	void HandleScoreRequest(const FPendingScoreRequest& Request);
+
+	//the most a shot can be behind the server clock and still be scored, the shooter's round trip and HitTimeMargin
+	float GetMaxShotAge() const;
+
+	//the client picks HitTime, so it is only rewound to if it is no newer than now and no older than the shooter's
+	//round trip time plus HitTimeMargin. Anything else would let a client choose whichever recorded frame suits it
+	bool IsHitTimeValid(float HitTime) const;
+
+	//the client sends where its trace started, which is only trusted if it is near the muzzle of the weapon this
+	//character holds on the server, give or take how far the character could have moved since the shot
+	bool IsTraceStartValid(const FVector& TraceStart, const AWeapon* Weapon, float HitTime) const;
+
+	//index into the ring buffer of the frame that is Offset frames newer than the oldest recorded frame
+	FORCEINLINE int32 FrameIndex(int32 Offset) const { return (Head - NumFrames + Offset + MaxFrames) % MaxFrames; }
+
+	//how far back in time the server is willing to rewind
+	UPROPERTY(EditAnywhere, Category = "Lag Compensation")
+	float MaxRecordTime = 4.f;
+
+	//frames recorded per second, matched to the character NetUpdateFrequency since clients never see more states than that
+	UPROPERTY(EditAnywhere, Category = "Lag Compensation")
+	float RecordFrequency = 66.f;
+
+	//slack on top of the shooter's round trip time for how old a HitTime may be, which covers jitter and a frame or two
+	UPROPERTY(EditAnywhere, Category = "Lag Compensation")
+	float HitTimeMargin = 0.2f;
+
+	//accepted shots without a score request and score requests without a shot, each kept up to this many. A shot that
+	//missed never gets a request, so the oldest is given up on first
+	UPROPERTY(EditAnywhere, Category = "Lag Compensation")
+	int32 MaxUnscoredShots = 16;
+
+	//how far a trace start may be from the server's muzzle location before any movement allowance
+	UPROPERTY(EditAnywhere, Category = "Lag Compensation")
+	float MaxTraceStartError = 100.f;
+
+	/**
+	 * Frame history
+	 * Ring buffer laid out as struct of arrays. FrameTimes holds one entry per frame and the box arrays hold NumBoxes
+	 * entries per frame back to back, so a frame is one contiguous run of memory. Everything is allocated once in BeginPlay
+	 */
+
+	TArray<float> FrameTimes;
+	TArray<FVector3f> FrameLocations;
+	TArray<FQuat4f> FrameRotations;
+
+	int32 MaxFrames = 0;
+	int32 NumBoxes = 0;
+	//slot the next frame is written to
+	int32 Head = 0;
+	int32 NumFrames = 0;
+	float LastRecordTime = -1.f;
+
+	//only ever filled on the server
+	TArray<FAcceptedShot> AcceptedShots;
+	TArray<FPendingScoreRequest> PendingScores;
+
+	//where the animation had the boxes before a rewind, so they can be put back afterwards
+	TArray<FVector> SavedRelativeLocations;
+	TArray<FRotator> SavedRelativeRotations;
+	bool bRewound = false;
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AimState.generated.h"
+
+//where a character is aiming, as everyone who doesn't control it gets it. Only the pitch is sent, the aim yaw is the
+//actor yaw which already comes with the replicated movement
+USTRUCT()
+struct FBlasterAimState
+{
+	GENERATED_BODY()
+
+	//signed pitch from -90 to 90 in one byte, twice the resolution RemoteViewPitch gets out of the same byte since it
+	//spends half its range on pitches a character can never aim at. The range is split into 254 steps rather than 255
+	//so level aim, 127, comes back as exactly 0. 255 is never sent
+	UPROPERTY()
+	uint8 PackedPitch = 127;
+
+	FORCEINLINE void SetPitch(float Pitch)
+	{
+		PackedPitch = static_cast<uint8>(FMath::RoundToInt((FMath::Clamp(Pitch, -90.f, 90.f) + 90.f) * 254.f / 180.f));
+	}
+
+	FORCEINLINE float GetPitch() const
+	{
+		return (FMath::Min<int32>(PackedPitch, 254) - 127) * 180.f / 254.f;
+	}
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+	{
+		Ar << PackedPitch;
+		bOutSuccess = true;
+		return true;
+	}
+
+	bool operator==(const FBlasterAimState& Other) const { return PackedPitch == Other.PackedPitch; }
+	bool operator!=(const FBlasterAimState& Other) const { return PackedPitch != Other.PackedPitch; }
+};
+
+template<>
+struct TStructOpsTypeTraits<FBlasterAimState> : public TStructOpsTypeTraitsBase2<FBlasterAimState>
+{
+	enum
+	{
+		WithNetSerializer = true,
+		WithIdenticalViaEquality = true
+	};
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BuffState.generated.h"
+
+//what the active buffs add up to, which is all a client needs of them. Health is already replicated on its own, so
+//heals over time never show up in here
+USTRUCT()
+struct FBuffState
+{
+	GENERATED_BODY()
+
+	//multipliers are kept in 1/32 steps so the server moves the character at exactly the speed the owning client
+	//predicts with once this arrives, up to just under 8x
+	UPROPERTY()
+	uint8 PackedSpeedMultiplier = 32;
+
+	UPROPERTY()
+	uint8 PackedJumpMultiplier = 32;
+
+	UPROPERTY()
+	float Shield = 0.f;
+
+	FORCEINLINE static uint8 PackMultiplier(float Multiplier)
+	{
+		return static_cast<uint8>(FMath::Clamp(FMath::RoundToInt(Multiplier * 32.f), 0, 255));
+	}
+
+	FORCEINLINE float GetSpeedMultiplier() const { return PackedSpeedMultiplier / 32.f; }
+	FORCEINLINE float GetJumpMultiplier() const { return PackedJumpMultiplier / 32.f; }
+
+	//one bit for each value that isn't at its default, so a character without buffs costs three bits
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+	{
+		uint8 bHasSpeed = PackedSpeedMultiplier != 32;
+		uint8 bHasJump = PackedJumpMultiplier != 32;
+		uint8 bHasShield = Shield > 0.f;
+		Ar.SerializeBits(&bHasSpeed, 1);
+		Ar.SerializeBits(&bHasJump, 1);
+		Ar.SerializeBits(&bHasShield, 1);
+
+		if(bHasSpeed){
+			Ar << PackedSpeedMultiplier;
+		}
+		else if(Ar.IsLoading()){
+			PackedSpeedMultiplier = 32;
+		}
+
+		if(bHasJump){
+			Ar << PackedJumpMultiplier;
+		}
+		else if(Ar.IsLoading()){
+			PackedJumpMultiplier = 32;
+		}
+
+		//the shield only goes to the HUD, so it travels in whole points, rounded up so a nearly spent shield still shows
+		uint16 PackedShield = static_cast<uint16>(FMath::Clamp(FMath::CeilToInt(Shield), 0, MAX_uint16));
+		if(bHasShield){
+			Ar << PackedShield;
+		}
+		if(Ar.IsLoading()){
+			Shield = bHasShield ? PackedShield : 0.f;
+		}
+
+		bOutSuccess = true;
+		return true;
+	}
+
+	bool operator==(const FBuffState& Other) const
+	{
+		return PackedSpeedMultiplier == Other.PackedSpeedMultiplier && PackedJumpMultiplier == Other.PackedJumpMultiplier && Shield == Other.Shield;
+	}
+	bool operator!=(const FBuffState& Other) const { return !(*this == Other); }
+};
+
+template<>
+struct TStructOpsTypeTraits<FBuffState> : public TStructOpsTypeTraitsBase2<FBuffState>
+{
+	enum
+	{
+		WithNetSerializer = true
+	};
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/NetSerialization.h"
+#include "FireCommand.generated.h"
+
+//one shot as the shooting client sends it to the server. Several of these go up together in every fire batch
+USTRUCT()
+struct FFireCommand
+{
+	GENERATED_BODY()
+
+	//counts up with every shot so the server can skip the ones it already got in an earlier batch
+	UPROPERTY()
+	uint16 Sequence = 0;
+
+	UPROPERTY()
+	FVector_NetQuantize HitTarget;
+
+	UPROPERTY()
+	FVector_NetQuantize TraceStart;
+
+	//only weapons with spread or projectiles to match care about the seed, everything else leaves it at 0 and it costs one bit
+	UPROPERTY()
+	int32 ScatterSeed = 0;
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+	{
+		Ar << Sequence;
+
+		bool bLocalSuccess = true;
+		HitTarget.NetSerialize(Ar, Map, bLocalSuccess);
+		bOutSuccess = bLocalSuccess;
+		TraceStart.NetSerialize(Ar, Map, bLocalSuccess);
+		bOutSuccess &= bLocalSuccess;
+
+		uint8 bHasSeed = ScatterSeed != 0;
+		Ar.SerializeBits(&bHasSeed, 1);
+		if(bHasSeed){
+			Ar << ScatterSeed;
+		}
+		else if(Ar.IsLoading()){
+			ScatterSeed = 0;
+		}
+		return true;
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FFireCommand> : public TStructOpsTypeTraitsBase2<FFireCommand>
+{
+	enum
+	{
+		WithNetSerializer = true
+	};
+};
+
+//true if sequence A came after sequence B, allowing for the counter wrapping around
+FORCEINLINE bool IsNewerFireSequence(uint16 A, uint16 B)
+{
+	return static_cast<int16>(A - B) > 0;
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+UENUM(BlueprintType)
+enum class ESignificanceLevel : uint8
+{
+    ESL_High UMETA(DisplayName = "High"),
+    ESL_Medium UMETA(DisplayName = "Medium"),
+    ESL_Low UMETA(DisplayName = "Low"),
+    ESL_Culled UMETA(DisplayName = "Culled"),
+
+    ESL_MAX UMETA(DisplayName = "DefaultMAX")
+};
@@ -5,8 +5,42 @@
 #include "CoreMinimal.h"
 #include "Animation/AnimInstance.h"
 #include "Blaster/BlasterTypes/TurningInPlace.h"
+#include "Blaster/BlasterTypes/CombatState.h"
 #include "BlasterAnimInstance.generated.h"
 
+/**
+ * Everything the animation update needs from the character, copied on the game thread so the rest of the update can
+ * run on a worker thread without touching the character, its components or the weapon
+ */
+struct FBlasterAnimGatherData
+{
+	FVector Velocity = FVector::ZeroVector;
+	FRotator AimRotation = FRotator::ZeroRotator;
+	FRotator ActorRotation = FRotator::ZeroRotator;
+	FVector HitTarget = FVector::ZeroVector;
+
+	//weapon's left hand socket, the character's right hand bone and the weapon's right hand socket, all in world space
+	FTransform LeftHandSocketTransform;
+	FTransform RightHandBoneTransform;
+	FTransform RightHandSocketTransform;
+
+	float AO_Yaw = 0.f;
+	float AO_Pitch = 0.f;
+	ETurningInPlace TurningInPlace = ETurningInPlace::ETIP_NotTurning;
+	ECombatState CombatState = ECombatState::ECS_Unoccupied;
+
+	bool bIsFalling = false;
+	bool bIsAccelerating = false;
+	bool bWeaponEquipped = false;
+	bool bHasWeaponMesh = false;
+	bool bIsCrouched = false;
+	bool bAiming = false;
+	bool bRotateRootBone = false;
+	bool bElimmed = false;
+	bool bLocallyControlled = false;
+	bool bDisableGameplay = false;
+};
+
 /**
  * 
  */
@@ -19,9 +53,15 @@ public:
 
 	virtual void NativeInitializeAnimation() override;
 	virtual void NativeUpdateAnimation(float DeltaTime) override;
+	virtual void NativeThreadSafeUpdateAnimation(float DeltaTime) override;
 
 private:
 
+	//game thread half of the update, the thread safe update only ever reads this
+	void GatherCharacterData();
+
+	FBlasterAnimGatherData GatherData;
+
 	UPROPERTY(BlueprintReadOnly, Category = Character, meta = (AllowPrivateAccess = "true"))
 	class ABlasterCharacter* BlasterCharacter;
 
@@ -37,8 +77,6 @@ private:
 	UPROPERTY(BlueprintReadOnly, Category = Movement, meta = (AllowPrivateAccess = "true"))
 	bool bWeaponEquipped;
 
-	class AWeapon* EquippedWeapon;
-
 	UPROPERTY(BlueprintReadOnly, Category = Movement, meta = (AllowPrivateAccess = "true"))
 	bool bIsCrouched;
 
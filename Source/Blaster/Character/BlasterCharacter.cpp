@@ -7,9 +7,13 @@
 #include "GameFramework/CharacterMovementComponent.h"
 #include "Components/WidgetComponent.h"
 #include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
 #include "Blaster/Weapon/Weapon.h"
 #include "Blaster/BlasterComponents/CombatComponent.h"
 #include "Blaster/BlasterComponents/BuffComponent.h"
+#include "Blaster/BlasterComponents/LagCompensationComponent.h"
+#include "Blaster/BlasterComponents/BlasterCharacterMovementComponent.h"
+#include "Components/BoxComponent.h"
 #include "Components/CapsuleComponent.h"
 #include "Kismet/KismetMathLibrary.h"
 #include "BlasterAnimInstance.h"
@@ -22,9 +26,32 @@
 #include "Particles/ParticleSystemComponent.h"
 #include "Blaster/PlayerState/BlasterPlayerState.h"
 #include "Blaster/Weapon/WeaponTypes.h"
+#include "BlasterSignificanceSubsystem.h"
+#include "Blaster/Replication/BlasterReplicationGraph.h"
+
+//bones that get a hit box for server-side rewind. The box sizes come from HitBoxExtents on the character blueprint
+static const FName HitBoxBoneNames[] = {
+	FName("head"),
+	FName("pelvis"),
+	FName("spine_02"),
+	FName("spine_03"),
+	FName("upperarm_l"),
+	FName("upperarm_r"),
+	FName("lowerarm_l"),
+	FName("lowerarm_r"),
+	FName("hand_l"),
+	FName("hand_r"),
+	FName("thigh_l"),
+	FName("thigh_r"),
+	FName("calf_l"),
+	FName("calf_r"),
+	FName("foot_l"),
+	FName("foot_r")
+};
 
 // Sets default values
-ABlasterCharacter::ABlasterCharacter()
+ABlasterCharacter::ABlasterCharacter(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer.SetDefaultSubobjectClass<UBlasterCharacterMovementComponent>(ACharacter::CharacterMovementComponentName))
 {
  	// Set this character to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = true;
@@ -47,20 +74,29 @@ ABlasterCharacter::ABlasterCharacter()
 	Buff = CreateDefaultSubobject<UBuffComponent>(TEXT("BuffComponent"));
 	Buff->SetIsReplicated(true);
 
+	//this needs to replicate so the owning client can send its score requests through it
+	LagCompensation = CreateDefaultSubobject<ULagCompensationComponent>(TEXT("LagCompensationComponent"));
+	LagCompensation->SetIsReplicated(true);
+
 	GetCharacterMovement()->NavAgentProps.bCanCrouch = true;
 
 	GetCapsuleComponent()->SetCollisionResponseToChannel(ECollisionChannel::ECC_Camera, ECollisionResponse::ECR_Ignore);
 	GetMesh()->SetCollisionObjectType(ECC_SkeletalMesh);
 	GetMesh()->SetCollisionResponseToChannel(ECollisionChannel::ECC_Visibility, ECollisionResponse::ECR_Block);
 	GetMesh()->SetCollisionResponseToChannel(ECollisionChannel::ECC_Camera, ECollisionResponse::ECR_Ignore);
+	//rewind traces should only ever hit the hit boxes, never the live capsule or mesh
+	GetCapsuleComponent()->SetCollisionResponseToChannel(ECC_HitBox, ECollisionResponse::ECR_Ignore);
+	GetMesh()->SetCollisionResponseToChannel(ECC_HitBox, ECollisionResponse::ECR_Ignore);
 	GetCharacterMovement()->RotationRate = FRotator(0.f, 0.f, 720.f);
 
-	//this is the fix for the bullets not spawning when the clients were not in view of the server!
-	GetMesh()->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
+	//characters nobody can see only tick their montages, so the notifies still fire. Firing refreshes the pose on demand
+	//through RefreshPoseForFiring so bullets still come out of the muzzle of characters that are off screen
+	GetMesh()->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickMontagesWhenNotRendered;
 
 	TurningInPlace = ETurningInPlace::ETIP_NotTurning;
 
 	//LOOK AT NOTES FOR EXTRA INFO ON THE CONFIG FILE
+	//these are only the starting rates, the server raises and lowers NetUpdateFrequency in UpdateNetUpdateFrequency
 	NetUpdateFrequency = 66.f;
 	MinNetUpdateFrequency = 33.f;
 
@@ -69,6 +105,17 @@ ABlasterCharacter::ABlasterCharacter()
 	AttachedGrenade = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("AttachedGrenade"));
 	AttachedGrenade->SetupAttachment(GetMesh(), FName("GrenadeSocket"));
 	AttachedGrenade->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+
+	for(const FName& BoneName : HitBoxBoneNames){
+		UBoxComponent* HitBox = CreateDefaultSubobject<UBoxComponent>(BoneName);
+		HitBox->SetupAttachment(GetMesh(), BoneName);
+		HitBox->SetBoxExtent(DefaultHitBoxExtent);
+		HitBox->SetCollisionObjectType(ECC_HitBox);
+		HitBox->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
+		HitBox->SetCollisionResponseToChannel(ECC_HitBox, ECollisionResponse::ECR_Block);
+		HitBox->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		HitCollisionBoxes.Add(HitBox);
+	}
 }
 
 // Called when the game starts or when spawned
@@ -82,10 +129,47 @@ void ABlasterCharacter::BeginPlay()
 	if(HasAuthority()){
 		//this is a delegate inherited from Actor.h
 		OnTakeAnyDamage.AddDynamic(this, &ThisClass::ReceiveDamage);
+
+		if(ABlasterGameMode* BlasterGameMode = GetWorld()->GetAuthGameMode<ABlasterGameMode>()){
+			BlasterGameMode->RegisterCharacter(this);
+		}
+
+		//the hit boxes ride on the bones and the server records them every frame for server-side rewind, so the server
+		//has to keep the real pose whether or not it draws anything
+		GetMesh()->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
 	}
 	if(AttachedGrenade){
 		AttachedGrenade->SetVisibility(false);
 	}
+
+	//enough snapshots to reach back past the turn rate sample however often they come in
+	const int32 SnapshotsNeeded = FMath::CeilToInt((ProxyPlayoutDelay + ProxyTurnSampleTime) / GetProxySnapshotInterval()) + 2;
+	ProxySnapshots.Init(FMath::Max(ProxySnapshotCapacity, SnapshotsNeeded));
+
+	//only other players' characters get scaled down, anything this machine controls or simulates for real keeps full rate
+	if(GetLocalRole() == ENetRole::ROLE_SimulatedProxy){
+		if(UBlasterSignificanceSubsystem* SignificanceSubsystem = GetWorld()->GetSubsystem<UBlasterSignificanceSubsystem>()){
+			SignificanceSubsystem->RegisterCharacter(this);
+		}
+	}
+}
+
+void ABlasterCharacter::SetSignificance(ESignificanceLevel Level, const FSignificanceSettings &Settings)
+{
+	Significance = Level;
+	bPlayDetailEffects = Settings.bDetailEffects;
+
+	SetActorTickInterval(Settings.TickInterval);
+	if(Combat){
+		Combat->SetComponentTickInterval(Settings.TickInterval);
+	}
+	if(Buff){
+		Buff->SetComponentTickInterval(Settings.TickInterval);
+	}
+	if(GetMesh()){
+		GetMesh()->SetComponentTickInterval(Settings.AnimTickInterval);
+		GetMesh()->bEnableUpdateRateOptimizations = Settings.bUpdateRateOptimizations;
+	}
 }
 
 // Called to bind functionality to input
@@ -120,15 +204,67 @@ void ABlasterCharacter::GetLifetimeReplicatedProps(TArray<FLifetimeProperty> &Ou
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
 	DOREPLIFETIME_CONDITION(ABlasterCharacter, OverlappingWeapon, COND_OwnerOnly);
-	DOREPLIFETIME(ABlasterCharacter, CurrentHealth);
-	DOREPLIFETIME(ABlasterCharacter, bDisableGameplay);
+
+	//these only change when something happens to the character, so they are pushed instead of compared every net update
+	FDoRepLifetimeParams PushParams;
+	PushParams.bIsPushBased = true;
+	DOREPLIFETIME_WITH_PARAMS_FAST(ABlasterCharacter, CurrentHealth, PushParams);
+	DOREPLIFETIME_WITH_PARAMS_FAST(ABlasterCharacter, bDisableGameplay, PushParams);
+
+	//RemoteViewPitch wraps negative pitches around to [270, 360) and spends half its byte on pitches nobody can aim
+	//at. AimState carries the same byte signed, and only to the machines that animate from it
+	DISABLE_REPLICATED_PROPERTY(APawn, RemoteViewPitch);
+	FDoRepLifetimeParams AimParams;
+	AimParams.bIsPushBased = true;
+	AimParams.Condition = COND_SimulatedOnly;
+	DOREPLIFETIME_WITH_PARAMS_FAST(ABlasterCharacter, AimState, AimParams);
+}
+
+void ABlasterCharacter::SetHealth(float Amount)
+{
+	CurrentHealth = Amount;
+	MARK_PROPERTY_DIRTY_FROM_NAME(ABlasterCharacter, CurrentHealth, this);
+}
+
+void ABlasterCharacter::SetDisableGameplay(bool bDisable)
+{
+	bDisableGameplay = bDisable;
+	MARK_PROPERTY_DIRTY_FROM_NAME(ABlasterCharacter, bDisableGameplay, this);
 }
 
 void ABlasterCharacter::OnRep_ReplicatedMovement()
 {
 	Super::OnRep_ReplicatedMovement();
-	SimProxiesTurn();
-	TimeSinceLastMovementReplication = 0.f;
+	RecordProxySnapshot();
+}
+
+void ABlasterCharacter::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+	Super::PreReplication(ChangedPropertyTracker);
+
+	//same place APawn sets RemoteViewPitch, so the pitch is only packed when the character is about to be sent
+	if(HasAuthority() && GetController()){
+		FBlasterAimState NewAimState;
+		NewAimState.SetPitch(FRotator::NormalizeAxis(GetController()->GetControlRotation().Pitch));
+		if(NewAimState != AimState){
+			AimState = NewAimState;
+			MARK_PROPERTY_DIRTY_FROM_NAME(ABlasterCharacter, AimState, this);
+		}
+	}
+}
+
+FRotator ABlasterCharacter::GetBaseAimRotation() const
+{
+	if(Controller == nullptr){
+		return FRotator(AimState.GetPitch(), GetActorRotation().Yaw, 0.f);
+	}
+	return Super::GetBaseAimRotation();
+}
+
+void ABlasterCharacter::OnRep_AimState()
+{
+	//the pitch can change without the movement changing, so a new pitch counts as an update of its own
+	RecordProxySnapshot();
 }
 
 void ABlasterCharacter::Elim()
@@ -150,7 +286,10 @@ void ABlasterCharacter::MulticastElim_Implementation()
 
 	//Set up and start the dissolve effect
 	if(DissolveMaterialInstance){
-		DynamicDissolveMaterialInstance = UMaterialInstanceDynamic::Create(DissolveMaterialInstance, this);
+		//a recycled character keeps the instance it made on its first elim
+		if(DynamicDissolveMaterialInstance == nullptr){
+			DynamicDissolveMaterialInstance = UMaterialInstanceDynamic::Create(DissolveMaterialInstance, this);
+		}
 		GetMesh()->SetMaterial(0, DynamicDissolveMaterialInstance);
 		DynamicDissolveMaterialInstance->SetScalarParameterValue(TEXT("Dissolve"), 0.55f);
 		DynamicDissolveMaterialInstance->SetScalarParameterValue(TEXT("Glow"), 200.f);
@@ -162,7 +301,7 @@ void ABlasterCharacter::MulticastElim_Implementation()
 	// if(BlasterPlayerController){
 	// 	DisableInput(BlasterPlayerController); //prevents firing
 	// }
-	bDisableGameplay = true;
+	SetDisableGameplay(true);
 	//this will also prevent the player from falling throught the floor when they are killed during the death animation
 	GetCharacterMovement()->DisableMovement(); //stops WASD input
 	if(Combat){
@@ -192,6 +331,61 @@ void ABlasterCharacter::MulticastElim_Implementation()
 	}
 }
 
+void ABlasterCharacter::ResetForRespawn(const FVector& Location, const FRotator& Rotation)
+{
+	GetWorldTimerManager().ClearTimer(ElimTimer);
+
+	SetHealth(MaxHealth);
+	SetDisableGameplay(false);
+	SetOverlappingWeapon(nullptr);
+
+	if(Buff){
+		Buff->ResetForRespawn();
+	}
+	//the old history is of the body that just dissolved, nothing should be able to rewind onto it
+	if(LagCompensation){
+		LagCompensation->ClearHistory();
+	}
+
+	MulticastRespawn(Location, Rotation);
+}
+
+void ABlasterCharacter::MulticastRespawn_Implementation(const FVector_NetQuantize& Location, const FRotator& Rotation)
+{
+	TeleportTo(Location, Rotation, false, true);
+	//the old snapshots would have the animation turn all the way round from where the body died
+	ProxySnapshots.Reset();
+	bHasSmoothedProxyState = false;
+	GetCharacterMovement()->StopMovementImmediately();
+	GetCharacterMovement()->SetDefaultMovementMode();
+
+	bElimmed = false;
+	if(UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance()){
+		AnimInstance->StopAllMontages(0.f);
+	}
+
+	//undo the dissolve with whatever the blueprint gives a new character
+	if(DissolveTimeline){
+		DissolveTimeline->Stop();
+	}
+	const USkeletalMeshComponent* MeshDefaults = CastChecked<USkeletalMeshComponent>(GetMesh()->GetArchetype());
+	GetMesh()->SetMaterial(0, MeshDefaults->GetMaterial(0));
+
+	GetCapsuleComponent()->SetCollisionEnabled(CastChecked<UCapsuleComponent>(GetCapsuleComponent()->GetArchetype())->GetCollisionEnabled());
+	GetMesh()->SetCollisionEnabled(MeshDefaults->GetCollisionEnabled());
+
+	if(ElimBotComponent){
+		ElimBotComponent->DestroyComponent();
+		ElimBotComponent = nullptr;
+	}
+
+	if(Combat){
+		Combat->ResetForRespawn();
+	}
+	TurningInPlace = ETurningInPlace::ETIP_NotTurning;
+	UpdateHUDHealth();
+}
+
 void ABlasterCharacter::ElimTimerFinished()
 {
 	ABlasterGameMode* BlasterGameMode = GetWorld()->GetAuthGameMode<ABlasterGameMode>();
@@ -204,11 +398,18 @@ void ABlasterCharacter::Destroyed()
 {
 	Super::Destroyed();
 
+	if(UBlasterSignificanceSubsystem* SignificanceSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UBlasterSignificanceSubsystem>() : nullptr){
+		SignificanceSubsystem->UnregisterCharacter(this);
+	}
+
 	if(ElimBotComponent){
 		ElimBotComponent->DestroyComponent();
 	}
 
 	ABlasterGameMode* BlasterGameMode = Cast<ABlasterGameMode>(UGameplayStatics::GetGameMode(this));
+	if(BlasterGameMode){
+		BlasterGameMode->UnregisterCharacter(this);
+	}
 	bool bMatchNotInProgress = BlasterGameMode && BlasterGameMode->GetMatchState() != MatchState::InProgress;
 	if(Combat && Combat->EquippedWeapon && bMatchNotInProgress)
 	{
@@ -225,10 +426,13 @@ void ABlasterCharacter::UpdateDissolveMaterial(float DissolveValue)
 
 void ABlasterCharacter::StartDissolve()
 {
-	DissolveTrack.BindDynamic(this, &ThisClass::UpdateDissolveMaterial);
 	if(DissolveCurve && DissolveTimeline){
-		DissolveTimeline->AddInterpFloat(DissolveCurve, DissolveTrack);
-		DissolveTimeline->Play();
+		//a recycled character dissolves more than once, so the track is only added the first time
+		if(!DissolveTrack.IsBound()){
+			DissolveTrack.BindDynamic(this, &ThisClass::UpdateDissolveMaterial);
+			DissolveTimeline->AddInterpFloat(DissolveCurve, DissolveTrack);
+		}
+		DissolveTimeline->PlayFromStart();
 	}
 }
 
@@ -244,6 +448,18 @@ void ABlasterCharacter::PostInitializeComponents()
 	{
 		Buff->Character = this;
 	}
+
+	if(LagCompensation){
+		LagCompensation->Character = this;
+	}
+
+	//the constructor can only use the native default, blueprint values are in by now
+	for(UBoxComponent* HitBox : HitCollisionBoxes){
+		if(HitBox){
+			const FVector* Extent = HitBoxExtents.Find(HitBox->GetAttachSocketName());
+			HitBox->SetBoxExtent(Extent ? *Extent : DefaultHitBoxExtent, false);
+		}
+	}
 }
 
 void ABlasterCharacter::PlayFireMontage(bool bAiming)
@@ -262,6 +478,22 @@ void ABlasterCharacter::PlayFireMontage(bool bAiming)
 	}
 }
 
+void ABlasterCharacter::RefreshPoseForFiring()
+{
+	USkeletalMeshComponent* CharacterMesh = GetMesh();
+	if(CharacterMesh == nullptr) {return;}
+	//a rendered or always ticking mesh already has this frame's pose
+	if(CharacterMesh->VisibilityBasedAnimTickOption == EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones ||
+		CharacterMesh->WasRecentlyRendered()) {return;}
+	if(LastPoseRefreshFrame == GFrameCounter) {return;}
+	LastPoseRefreshFrame = GFrameCounter;
+
+	//update the anim instance so aim offsets are current, evaluate the pose, then move the weapon along with the hand
+	CharacterMesh->TickAnimation(0.f, false);
+	CharacterMesh->RefreshBoneTransforms();
+	CharacterMesh->UpdateChildTransforms();
+}
+
 void ABlasterCharacter::PlayReloadMontage()
 {
 	if(Combat == nullptr || Combat->EquippedWeapon == nullptr){
@@ -357,7 +589,13 @@ void ABlasterCharacter::GrenadeButtonPressed()
 void ABlasterCharacter::ReceiveDamage(AActor *DamagedActor, float Damage, const UDamageType *DamageType, AController *InstigatorController, AActor *DamageCaused)
 {
 	if(bElimmed) {return;}
+	NoteCombatActivity();
+	//a shield from a pickup takes the hit before health does
+	if(Buff){
+		Damage = Buff->AbsorbDamage(Damage);
+	}
 	CurrentHealth = FMath::Clamp(CurrentHealth - Damage, 0.f, MaxHealth);
+	MARK_PROPERTY_DIRTY_FROM_NAME(ABlasterCharacter, CurrentHealth, this);
 	UpdateHUDHealth();
 	PlayHitReactMontage();
 
@@ -407,12 +645,61 @@ void ABlasterCharacter::RotateInPlace(float DeltaTime)
 		AimOffset(DeltaTime);
 	}
 	else{
-		TimeSinceLastMovementReplication += DeltaTime;
-		if(TimeSinceLastMovementReplication > 0.25f){
-			OnRep_ReplicatedMovement();
-		}
+		UpdateProxySmoothing();
+	}
+}
+
+void ABlasterCharacter::RecordProxySnapshot()
+{
+	ProxySnapshots.Add(GetWorld()->GetTimeSeconds(), GetActorRotation().Yaw, GetSignedAimPitch());
+}
+
+float ABlasterCharacter::GetProxySnapshotInterval() const
+{
+	//no character is sent more often than at the combat rate, so snapshots never arrive closer together than this
+	return 1.f / FMath::Max(CombatNetUpdateFrequency, 1.f);
+}
+
+void ABlasterCharacter::UpdateProxySmoothing()
+{
+	//the server sees every move of the characters it doesn't control as it happens, so it records them at the fastest
+	//rate proxies get updates at and reads the present. Simulated proxies record when movement or aim state arrives
+	//and read a little behind it
+	const bool bSimulatedProxy = GetLocalRole() == ENetRole::ROLE_SimulatedProxy;
+	const double Now = GetWorld()->GetTimeSeconds();
+	if(ProxySnapshots.IsEmpty() || (!bSimulatedProxy && Now - ProxySnapshots.Newest().Time >= GetProxySnapshotInterval())){
+		RecordProxySnapshot();
+	}
+
+	const double SampleTime = bSimulatedProxy ? Now - ProxyPlayoutDelay : Now;
+	FProxySnapshot EarlierState;
+	if(!ProxySnapshots.Sample(SampleTime, ProxyMaxExtrapolationTime, SmoothedProxyState) ||
+		!ProxySnapshots.Sample(SampleTime - ProxyTurnSampleTime, ProxyMaxExtrapolationTime, EarlierState)){
 		CalculateAO_Pitch();
+		return;
 	}
+	bHasSmoothedProxyState = true;
+
+	AO_Pitch = SmoothedProxyState.AimPitch;
+	ProxyYaw = FRotator::NormalizeAxis(SmoothedProxyState.Yaw - EarlierState.Yaw) / ProxyTurnSampleTime;
+	SimProxiesTurn();
+}
+
+FRotator ABlasterCharacter::GetAnimActorRotation() const
+{
+	FRotator Rotation = GetActorRotation();
+	if(bHasSmoothedProxyState && !IsLocallyControlled()){
+		Rotation.Yaw = SmoothedProxyState.Yaw;
+	}
+	return Rotation;
+}
+
+FRotator ABlasterCharacter::GetAnimAimRotation() const
+{
+	if(bHasSmoothedProxyState && !IsLocallyControlled()){
+		return FRotator(SmoothedProxyState.AimPitch, SmoothedProxyState.Yaw, 0.f);
+	}
+	return GetBaseAimRotation();
 }
 
 void ABlasterCharacter::MoveForward(float Value)
@@ -552,17 +839,14 @@ void ABlasterCharacter::AimOffset(float DeltaTime)
 
 void ABlasterCharacter::CalculateAO_Pitch()
 {
-	AO_Pitch = GetBaseAimRotation().Pitch;
-	//this is the fix for the buggy aiming. Since we know it does not occer on pawns we are controlling, we only need to
-	//adjust for pawns we are not locally controlling
-	if(AO_Pitch > 90.f && !IsLocallyControlled()){
-		//map pitch from [270, 360) to [-90, 0)
-		//this will fix the jerky up and down aiming that we saw when using the aim offsets in multiplayer
-		FVector2D InRange(270.f, 360.f);
-		FVector2D OutRange(-90.f, 0.f);
-		//this is the method that actually does the mapping of one range to another
-		AO_Pitch = FMath::GetMappedRangeValueClamped(InRange, OutRange, AO_Pitch);
-	}
+	AO_Pitch = GetSignedAimPitch();
+}
+
+float ABlasterCharacter::GetSignedAimPitch() const
+{
+	//simulated proxies already get a signed pitch from AimState. The server's copy of a client's control rotation
+	//comes out of the move compression in [0, 360), so looking down there reads as 270 to 360 until it is normalized
+	return FRotator::NormalizeAxis(GetBaseAimRotation().Pitch);
 }
 
 void ABlasterCharacter::SimProxiesTurn()
@@ -582,17 +866,13 @@ void ABlasterCharacter::SimProxiesTurn()
 		return;
 	}
 
-	ProxyRotationLastFrame = ProxyRotation;
-	ProxyRotation = GetActorRotation();
-	ProxyYaw = UKismetMathLibrary::NormalizedDeltaRotator(ProxyRotation, ProxyRotationLastFrame).Yaw;
+	//ProxyYaw is the turn rate of the smoothed state, worked out in UpdateProxySmoothing
 
-	// UE_LOG(LogTemp, Warning, TEXT("ProxyYaw: %f"), ProxyYaw);
-
-	if(FMath::Abs(ProxyYaw) > TurnThreshold){
-		if(ProxyYaw > TurnThreshold){
+	if(FMath::Abs(ProxyYaw) > ProxyTurnRateThreshold){
+		if(ProxyYaw > ProxyTurnRateThreshold){
 			TurningInPlace = ETurningInPlace::ETIP_Right;
 		}
-		else if(ProxyYaw < -TurnThreshold){
+		else if(ProxyYaw < -ProxyTurnRateThreshold){
 			TurningInPlace = ETurningInPlace::ETIP_Left;
 		}
 		else{
@@ -722,6 +1002,11 @@ void ABlasterCharacter::SetOverlappingWeapon(AWeapon *Weapon)
 	}
 }
 
+UBlasterCharacterMovementComponent* ABlasterCharacter::GetBlasterCharacterMovement() const
+{
+	return Cast<UBlasterCharacterMovementComponent>(GetCharacterMovement());
+}
+
 bool ABlasterCharacter::IsWeaponEquipped()
 {
     return (Combat && Combat->EquippedWeapon);
@@ -762,4 +1047,44 @@ void ABlasterCharacter::Tick(float DeltaTime)
 	RotateInPlace(DeltaTime);
 	HideCameraIfCharacterClose();
 	PollInit();
+
+	if(HasAuthority()){
+		UpdateNetUpdateFrequency(DeltaTime);
+	}
+}
+
+void ABlasterCharacter::NoteCombatActivity()
+{
+	LastCombatTime = GetWorld()->GetTimeSeconds();
+}
+
+void ABlasterCharacter::UpdateNetUpdateFrequency(float DeltaTime)
+{
+	const bool bInCombat = LastCombatTime >= 0.f && GetWorld()->GetTimeSeconds() - LastCombatTime < CombatNetUpdateTime;
+	float TargetFrequency = IdleNetUpdateFrequency;
+	if(bInCombat){
+		TargetFrequency = CombatNetUpdateFrequency;
+	}
+	else if(!GetVelocity().IsNearlyZero()){
+		TargetFrequency = MovingNetUpdateFrequency;
+	}
+
+	float NewFrequency = TargetFrequency;
+	if(TargetFrequency < NetUpdateFrequency){
+		NewFrequency = FMath::FInterpTo(NetUpdateFrequency, TargetFrequency, DeltaTime, NetUpdateFrequencyDecaySpeed);
+		if(NewFrequency - TargetFrequency < 0.5f){
+			NewFrequency = TargetFrequency;
+		}
+	}
+	else if(TargetFrequency > NetUpdateFrequency){
+		//whatever woke the character up should go out now, not at the end of the slow period
+		ForceNetUpdate();
+	}
+
+	NetUpdateFrequency = NewFrequency;
+	//the graph works in whole frames between updates, so the steps of a decay in progress aren't worth passing on
+	if(NewFrequency == TargetFrequency && NewFrequency != SettledNetUpdateFrequency){
+		SettledNetUpdateFrequency = NewFrequency;
+		UBlasterReplicationGraph::NotifyNetUpdateFrequencyChanged(this);
+	}
 }
\ No newline at end of file
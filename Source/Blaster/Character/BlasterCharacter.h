@@ -8,6 +8,9 @@
 #include "Blaster/BlasterTypes/TurningInPlace.h"
 #include "Components/TimelineComponent.h"
 #include "Blaster/BlasterTypes/CombatState.h"
+#include "Blaster/BlasterTypes/SignificanceLevel.h"
+#include "Blaster/BlasterTypes/AimState.h"
+#include "ProxySnapshotBuffer.h"
 #include "BlasterCharacter.generated.h"
 
 UCLASS()
@@ -17,7 +20,7 @@ class BLASTER_API ABlasterCharacter : public ACharacter, public IInteractWithCro
 
 public:
 	// Sets default values for this character's properties
-	ABlasterCharacter();
+	ABlasterCharacter(const FObjectInitializer& ObjectInitializer);
 
 	// Called every frame
 	virtual void Tick(float DeltaTime) override;
@@ -36,13 +39,29 @@ public:
 	void PlayElimMontage();
 	void PlayThrowGrenadeMontage();
 
+	//brings the mesh pose up to date when it isn't being rendered, so the muzzle and hand sockets are where they should be
+	//before a shot is fired from them
+	void RefreshPoseForFiring();
+
 	virtual void OnRep_ReplicatedMovement() override;
+	virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
+
+	//characters this machine doesn't control aim at the replicated AimState pitch instead of RemoteViewPitch
+	virtual FRotator GetBaseAimRotation() const override;
 
 	void Elim();
 
 	UFUNCTION(NetMulticast, Reliable)
 	void MulticastElim();
 
+	//brings an eliminated character back at Location instead of destroying it and spawning a new one. Server only
+	void ResetForRespawn(const FVector& Location, const FRotator& Rotation);
+
+	//the spawn transform is sent along so every machine teleports before it undoes the dissolve, otherwise proxies
+	//could show the restored mesh at the death spot until the next movement update
+	UFUNCTION(NetMulticast, Reliable)
+	void MulticastRespawn(const FVector_NetQuantize& Location, const FRotator& Rotation);
+
 	virtual void Destroyed() override;
 
 	UPROPERTY(Replicated)
@@ -53,6 +72,10 @@ public:
 
 	void UpdateHUDHealth();
 
+	//the server keeps a character that is fighting at its highest net update rate, and lets the rate fall off once
+	//the character has been out of combat for a while
+	void NoteCombatActivity();
+
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
@@ -91,6 +114,12 @@ protected:
 
 private:
 
+	ESignificanceLevel Significance = ESignificanceLevel::ESL_High;
+	bool bPlayDetailEffects = true;
+
+	//frame the pose was last refreshed for firing, so a burst in one frame only refreshes once
+	uint64 LastPoseRefreshFrame = 0;
+
 	UPROPERTY(VisibleAnywhere, Category = Camera)
 	class USpringArmComponent* CameraBoom;
 	UPROPERTY(VisibleAnywhere, Category = Camera)
@@ -113,6 +142,24 @@ private:
 	UPROPERTY(VisibleAnywhere)
 	class UBuffComponent* Buff;
 
+	UPROPERTY(VisibleAnywhere)
+	class ULagCompensationComponent* LagCompensation;
+
+	/**
+	 * Hit boxes used for server-side rewind
+	 */
+
+	//one box per bone in HitBoxBoneNames, in the same order. Collision is off unless the server is rewinding this character
+	UPROPERTY(VisibleAnywhere, Category = "Hit Boxes")
+	TArray<class UBoxComponent*> HitCollisionBoxes;
+
+	//half size of the hit box on each bone, keyed by bone name. Bones left out get DefaultHitBoxExtent
+	UPROPERTY(EditDefaultsOnly, Category = "Hit Boxes")
+	TMap<FName, FVector> HitBoxExtents;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Hit Boxes")
+	FVector DefaultHitBoxExtent = FVector(12.f, 12.f, 12.f);
+
 	UFUNCTION(Server, Reliable)
 	void ServerEquipButtonPressed();
 
@@ -154,14 +201,52 @@ private:
 	 * used in sim proxy rotation
 	 */
 	bool bRotateRootBone;
-	float TurnThreshold = 0.5f;
-	FRotator ProxyRotationLastFrame;
-	FRotator ProxyRotation;
-	//Yaw result of the delta calculation
+	//degrees per second of smoothed yaw before a character we don't control counts as turning in place
+	UPROPERTY(EditAnywhere, Category = "Proxy Smoothing")
+	float ProxyTurnRateThreshold = 20.f;
+	//yaw rate of the smoothed state, measured over ProxyTurnSampleTime
 	float ProxyYaw;
-	float TimeSinceLastMovementReplication;
 	float CalculateSpeed();
 
+	/**
+	 * Proxy smoothing
+	 * Characters this machine doesn't control are animated from a snapshot buffer read ProxyPlayoutDelay seconds in
+	 * the past, so aim offsets, turn in place and lean move evenly between updates however unevenly those arrive
+	 */
+
+	UPROPERTY(EditAnywhere, Category = "Proxy Smoothing")
+	float ProxyPlayoutDelay = 0.1f;
+
+	//how far past the newest snapshot the state keeps moving before it eases back
+	UPROPERTY(EditAnywhere, Category = "Proxy Smoothing")
+	float ProxyMaxExtrapolationTime = 0.1f;
+
+	UPROPERTY(EditAnywhere, Category = "Proxy Smoothing")
+	float ProxyTurnSampleTime = 0.1f;
+
+	//least number of snapshots kept. The buffer is made bigger if this many couldn't cover ProxyPlayoutDelay plus
+	//ProxyTurnSampleTime at one snapshot every GetProxySnapshotInterval
+	UPROPERTY(EditAnywhere, Category = "Proxy Smoothing")
+	int32 ProxySnapshotCapacity = 16;
+
+	FProxySnapshotBuffer ProxySnapshots;
+	FProxySnapshot SmoothedProxyState;
+	bool bHasSmoothedProxyState = false;
+
+	void RecordProxySnapshot();
+	void UpdateProxySmoothing();
+	float GetProxySnapshotInterval() const;
+	//the aim pitch as the aim offset wants it, -90 to 90
+	float GetSignedAimPitch() const;
+
+	//replaces RemoteViewPitch, which is turned off in GetLifetimeReplicatedProps. Set by the server right before the
+	//character replicates and only sent to simulated proxies
+	UPROPERTY(ReplicatedUsing = OnRep_AimState)
+	FBlasterAimState AimState;
+
+	UFUNCTION()
+	void OnRep_AimState();
+
 	/**
 	 * Player health
 	 */
@@ -229,6 +314,33 @@ private:
 	UPROPERTY()
 	class ABlasterPlayerState* BlasterPlayerState;
 
+	/**
+	 * Net update rate
+	 */
+
+	//net update rate while hitting or being hit, and for CombatNetUpdateTime seconds after
+	UPROPERTY(EditAnywhere, Category = "Net Update Rate")
+	float CombatNetUpdateFrequency = 66.f;
+
+	UPROPERTY(EditAnywhere, Category = "Net Update Rate")
+	float MovingNetUpdateFrequency = 33.f;
+
+	UPROPERTY(EditAnywhere, Category = "Net Update Rate")
+	float IdleNetUpdateFrequency = 10.f;
+
+	UPROPERTY(EditAnywhere, Category = "Net Update Rate")
+	float CombatNetUpdateTime = 2.f;
+
+	//how quickly the rate falls to a lower target, the rate always jumps straight up to a higher one
+	UPROPERTY(EditAnywhere, Category = "Net Update Rate")
+	float NetUpdateFrequencyDecaySpeed = 3.f;
+
+	float LastCombatTime = -1.f;
+	//the rate the replication graph was last told about. It only hears about rates the character has settled on
+	float SettledNetUpdateFrequency = -1.f;
+
+	void UpdateNetUpdateFrequency(float DeltaTime);
+
 	/**
 	 * Grenade
 	 */
@@ -255,15 +367,27 @@ public:
 
 	FORCEINLINE UCameraComponent* GetFollowCamera() const { return FollowCamera; }
 	FORCEINLINE bool ShouldRotateRootBone() const { return bRotateRootBone; }
+	//what the animation should use for this character's facing and aim. Smoothed for characters we don't control
+	FRotator GetAnimActorRotation() const;
+	FRotator GetAnimAimRotation() const;
 	FORCEINLINE bool IsElimmed() const { return bElimmed; }
 	FORCEINLINE float GetHealth() const { return CurrentHealth; }
-	FORCEINLINE void SetHealth(float Amount) { CurrentHealth = Amount; }
+	void SetHealth(float Amount);
 	FORCEINLINE float GetMaxHealth() const { return MaxHealth; }
 	ECombatState GetCombatState() const;
 	FORCEINLINE UCombatComponent* GetCombat() const { return Combat; }
+	class UBlasterCharacterMovementComponent* GetBlasterCharacterMovement() const;
 	FORCEINLINE bool GetDisableGameplay() const { return bDisableGameplay; }
+	void SetDisableGameplay(bool bDisable);
 	FORCEINLINE UAnimMontage* GetReloadMontage() const { return ReloadMontage; }
 	FORCEINLINE UStaticMeshComponent* GetAttachedGrenade() const { return AttachedGrenade; }
 	FORCEINLINE UBuffComponent* GetBuff() const { return Buff; }
+	FORCEINLINE ULagCompensationComponent* GetLagCompensation() const { return LagCompensation; }
+	FORCEINLINE const TArray<UBoxComponent*>& GetHitBoxes() const { return HitCollisionBoxes; }
+
+	//set by UBlasterSignificanceSubsystem on simulated proxies, everything else stays at high
+	void SetSignificance(ESignificanceLevel Level, const struct FSignificanceSettings& Settings);
+	FORCEINLINE ESignificanceLevel GetSignificance() const { return Significance; }
+	FORCEINLINE bool ShouldPlayDetailEffects() const { return bPlayDetailEffects; }
 
 };
@@ -0,0 +1,147 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "BlasterSignificanceSubsystem.h"
+#include "BlasterCharacter.h"
+#include "GameFramework/PlayerController.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Blaster/Blaster.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Significant Characters High"), STAT_SignificanceHigh, STATGROUP_Blaster);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Significant Characters Medium"), STAT_SignificanceMedium, STATGROUP_Blaster);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Significant Characters Low"), STAT_SignificanceLow, STATGROUP_Blaster);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Significant Characters Culled"), STAT_SignificanceCulled, STATGROUP_Blaster);
+
+UBlasterSignificanceSubsystem::UBlasterSignificanceSubsystem()
+{
+    //high keeps the struct defaults, every frame with all the effects
+    MediumSettings.TickInterval = 1.f / 30.f;
+    MediumSettings.bUpdateRateOptimizations = true;
+
+    LowSettings.TickInterval = 0.1f;
+    LowSettings.AnimTickInterval = 1.f / 15.f;
+    LowSettings.bUpdateRateOptimizations = true;
+    LowSettings.bDetailEffects = false;
+
+    CulledSettings.TickInterval = 0.25f;
+    CulledSettings.AnimTickInterval = 0.25f;
+    CulledSettings.bUpdateRateOptimizations = true;
+    CulledSettings.bDetailEffects = false;
+}
+
+const FSignificanceSettings& UBlasterSignificanceSubsystem::GetLevelSettings(ESignificanceLevel Level) const
+{
+    switch(Level){
+        case ESignificanceLevel::ESL_Medium:
+            return MediumSettings;
+        case ESignificanceLevel::ESL_Low:
+            return LowSettings;
+        case ESignificanceLevel::ESL_Culled:
+            return CulledSettings;
+        default:
+            return HighSettings;
+    }
+}
+
+bool UBlasterSignificanceSubsystem::ShouldCreateSubsystem(UObject *Outer) const
+{
+    //a dedicated server has no view to score against and needs every character at full rate anyway
+    UWorld* World = Cast<UWorld>(Outer);
+    return World && World->IsGameWorld() && !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+TStatId UBlasterSignificanceSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UBlasterSignificanceSubsystem, STATGROUP_Tickables);
+}
+
+void UBlasterSignificanceSubsystem::RegisterCharacter(ABlasterCharacter *Character)
+{
+    if(Character == nullptr) {return;}
+    FSignificanceEntry& Entry = Entries.AddDefaulted_GetRef();
+    Entry.Character = Character;
+    Character->SetSignificance(Entry.Level, GetLevelSettings(Entry.Level));
+    //score it on the next tick instead of leaving it at high until the next update
+    TimeSinceUpdate = UpdateInterval;
+}
+
+void UBlasterSignificanceSubsystem::UnregisterCharacter(ABlasterCharacter *Character)
+{
+    Entries.RemoveAllSwap([Character](const FSignificanceEntry& Entry) { return Entry.Character == Character; });
+}
+
+void UBlasterSignificanceSubsystem::NoteShotFired(ABlasterCharacter *Shooter, const FVector &HitTarget)
+{
+    APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+    APawn* LocalPawn = PlayerController ? PlayerController->GetPawn() : nullptr;
+    if(LocalPawn == nullptr || FVector::DistSquared(LocalPawn->GetActorLocation(), HitTarget) > FMath::Square(AttackRadius)) {return;}
+
+    for(FSignificanceEntry& Entry : Entries){
+        if(Entry.Character == Shooter){
+            Entry.LastAttackTime = GetWorld()->GetTimeSeconds();
+            //being shot at can't wait for the next update
+            if(Entry.Level != ESignificanceLevel::ESL_High){
+                Entry.Level = ESignificanceLevel::ESL_High;
+                Shooter->SetSignificance(Entry.Level, GetLevelSettings(Entry.Level));
+            }
+            return;
+        }
+    }
+}
+
+void UBlasterSignificanceSubsystem::Tick(float DeltaTime)
+{
+    TimeSinceUpdate += DeltaTime;
+    if(TimeSinceUpdate < UpdateInterval) {return;}
+    TimeSinceUpdate = 0.f;
+
+    APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+    if(PlayerController == nullptr) {return;}
+
+    FVector ViewLocation;
+    FRotator ViewRotation;
+    PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+    const float FOV = PlayerController->PlayerCameraManager ? PlayerController->PlayerCameraManager->GetFOVAngle() : 90.f;
+    //a little wider than the screen so characters at the edge don't flicker between levels
+    const float CosHalfFOV = FMath::Cos(FMath::DegreesToRadians(FMath::Min(FOV * 0.5f + 15.f, 179.f)));
+
+    int32 NumPerLevel[(uint8)ESignificanceLevel::ESL_MAX] = {};
+    for(int32 Index = Entries.Num() - 1; Index >= 0; --Index){
+        FSignificanceEntry& Entry = Entries[Index];
+        ABlasterCharacter* Character = Entry.Character.Get();
+        if(Character == nullptr){
+            Entries.RemoveAtSwap(Index);
+            continue;
+        }
+
+        const ESignificanceLevel Level = ScoreCharacter(Character, Entry, ViewLocation, ViewRotation.Vector(), CosHalfFOV);
+        if(Level != Entry.Level){
+            Entry.Level = Level;
+            Character->SetSignificance(Level, GetLevelSettings(Level));
+        }
+        NumPerLevel[(uint8)Level]++;
+    }
+
+    SET_DWORD_STAT(STAT_SignificanceHigh, NumPerLevel[(uint8)ESignificanceLevel::ESL_High]);
+    SET_DWORD_STAT(STAT_SignificanceMedium, NumPerLevel[(uint8)ESignificanceLevel::ESL_Medium]);
+    SET_DWORD_STAT(STAT_SignificanceLow, NumPerLevel[(uint8)ESignificanceLevel::ESL_Low]);
+    SET_DWORD_STAT(STAT_SignificanceCulled, NumPerLevel[(uint8)ESignificanceLevel::ESL_Culled]);
+}
+
+ESignificanceLevel UBlasterSignificanceSubsystem::ScoreCharacter(const ABlasterCharacter *Character, const FSignificanceEntry &Entry, const FVector &ViewLocation, const FVector &ViewDirection, float CosHalfFOV) const
+{
+    if(Entry.LastAttackTime >= 0.f && GetWorld()->GetTimeSeconds() - Entry.LastAttackTime < AttackMemory){
+        return ESignificanceLevel::ESL_High;
+    }
+
+    const FVector ToCharacter = Character->GetActorLocation() - ViewLocation;
+    const float Distance = ToCharacter.Size();
+    const bool bInView = Distance < KINDA_SMALL_NUMBER || FVector::DotProduct(ToCharacter / Distance, ViewDirection) >= CosHalfFOV;
+
+    if(bInView){
+        if(Distance < NearDistance) {return ESignificanceLevel::ESL_High;}
+        return Distance < FarDistance ? ESignificanceLevel::ESL_Medium : ESignificanceLevel::ESL_Low;
+    }
+    //someone right behind us could be on screen with a quick turn
+    return Distance < NearDistance ? ESignificanceLevel::ESL_Low : ESignificanceLevel::ESL_Culled;
+}
@@ -0,0 +1,105 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Blaster/BlasterTypes/SignificanceLevel.h"
+#include "BlasterSignificanceSubsystem.generated.h"
+
+class ABlasterCharacter;
+
+//what a character is allowed to spend at one significance level
+USTRUCT()
+struct FSignificanceSettings
+{
+	GENERATED_BODY()
+
+	//tick interval of the character and its combat and buff components, 0 is every frame
+	UPROPERTY(EditAnywhere)
+	float TickInterval = 0.f;
+
+	//tick interval of the character mesh, which is where the animation update happens
+	UPROPERTY(EditAnywhere)
+	float AnimTickInterval = 0.f;
+
+	//lets the engine skip animation frames with distance on top of the tick interval
+	UPROPERTY(EditAnywhere)
+	bool bUpdateRateOptimizations = false;
+
+	//beams, casings and other effects that don't change what happened
+	UPROPERTY(EditAnywhere)
+	bool bDetailEffects = true;
+};
+
+struct FSignificanceEntry
+{
+	TWeakObjectPtr<ABlasterCharacter> Character;
+	ESignificanceLevel Level = ESignificanceLevel::ESL_High;
+	//world time this character last shot at the local player
+	float LastAttackTime = -1.f;
+};
+
+/**
+ * Scores every simulated proxy character against the local player's view, by distance, whether it's on screen and
+ * whether it has just shot at us, and puts it in a significance level that decides how often it ticks and animates
+ * and which effects it plays. Characters this machine controls or has authority over are never touched
+ */
+UCLASS(Config = Game)
+class BLASTER_API UBlasterSignificanceSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UBlasterSignificanceSubsystem();
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterCharacter(ABlasterCharacter* Character);
+	void UnregisterCharacter(ABlasterCharacter* Character);
+
+	//a remote character fired at HitTarget. Shots landing close to the local player make the shooter significant
+	void NoteShotFired(ABlasterCharacter* Shooter, const FVector& HitTarget);
+
+private:
+
+	ESignificanceLevel ScoreCharacter(const ABlasterCharacter* Character, const FSignificanceEntry& Entry, const FVector& ViewLocation, const FVector& ViewDirection, float CosHalfFOV) const;
+
+	TArray<FSignificanceEntry> Entries;
+
+	float TimeSinceUpdate = 0.f;
+
+	//how often the levels are recomputed, the characters keep their settings in between
+	UPROPERTY(Config)
+	float UpdateInterval = 0.25f;
+
+	UPROPERTY(Config)
+	float NearDistance = 1500.f;
+
+	UPROPERTY(Config)
+	float FarDistance = 5000.f;
+
+	//how close to the local player a shot has to land for the shooter to count as an attacker
+	UPROPERTY(Config)
+	float AttackRadius = 600.f;
+
+	//how long an attacker stays at high significance after its last shot
+	UPROPERTY(Config)
+	float AttackMemory = 3.f;
+
+	const FSignificanceSettings& GetLevelSettings(ESignificanceLevel Level) const;
+
+	UPROPERTY(Config)
+	FSignificanceSettings HighSettings;
+
+	UPROPERTY(Config)
+	FSignificanceSettings MediumSettings;
+
+	UPROPERTY(Config)
+	FSignificanceSettings LowSettings;
+
+	UPROPERTY(Config)
+	FSignificanceSettings CulledSettings;
+};
@@ -0,0 +1,90 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ProxySnapshotBuffer.h"
+
+void FProxySnapshotBuffer::Init(int32 InCapacity)
+{
+	Snapshots.SetNumZeroed(FMath::Max(2, InCapacity));
+	Reset();
+}
+
+void FProxySnapshotBuffer::Reset()
+{
+	Head = 0;
+	NumSnapshots = 0;
+}
+
+const FProxySnapshot& FProxySnapshotBuffer::Newest() const
+{
+	return Snapshots[SnapshotIndex(NumSnapshots - 1)];
+}
+
+void FProxySnapshotBuffer::Add(double Time, float Yaw, float AimPitch)
+{
+	if(Snapshots.Num() == 0) {return;}
+
+	if(NumSnapshots > 0 && Time <= Newest().Time){
+		FProxySnapshot& NewestSnapshot = Snapshots[SnapshotIndex(NumSnapshots - 1)];
+		NewestSnapshot.Yaw = Yaw;
+		NewestSnapshot.AimPitch = AimPitch;
+		return;
+	}
+
+	FProxySnapshot& Snapshot = Snapshots[Head];
+	Snapshot.Time = Time;
+	Snapshot.Yaw = Yaw;
+	Snapshot.AimPitch = AimPitch;
+
+	Head = (Head + 1) % Snapshots.Num();
+	NumSnapshots = FMath::Min(NumSnapshots + 1, Snapshots.Num());
+}
+
+bool FProxySnapshotBuffer::Sample(double Time, float MaxExtrapolation, FProxySnapshot& OutSnapshot) const
+{
+	if(NumSnapshots == 0) {return false;}
+
+	const FProxySnapshot& Oldest = Snapshots[SnapshotIndex(0)];
+	const FProxySnapshot& NewestSnapshot = Newest();
+	OutSnapshot.Time = Time;
+
+	if(Time <= Oldest.Time || NumSnapshots == 1){
+		OutSnapshot.Yaw = NumSnapshots == 1 ? NewestSnapshot.Yaw : Oldest.Yaw;
+		OutSnapshot.AimPitch = NumSnapshots == 1 ? NewestSnapshot.AimPitch : Oldest.AimPitch;
+		return true;
+	}
+
+	if(Time >= NewestSnapshot.Time){
+		const FProxySnapshot& Previous = Snapshots[SnapshotIndex(NumSnapshots - 2)];
+		const double Span = NewestSnapshot.Time - Previous.Time;
+		const float Ahead = static_cast<float>(Time - NewestSnapshot.Time);
+		//carried on at first, then eased back in
+		const float ExtrapolationTime = Ahead < MaxExtrapolation ? Ahead : FMath::Max(0.f, 2.f * MaxExtrapolation - Ahead);
+		//two snapshots a hair apart would turn a tiny turn into a huge rate, so never carry on past one more span's worth
+		const float Alpha = Span > 0.0 ? FMath::Min(ExtrapolationTime / static_cast<float>(Span), 1.f) : 0.f;
+
+		OutSnapshot.Yaw = FRotator::NormalizeAxis(NewestSnapshot.Yaw + FRotator::NormalizeAxis(NewestSnapshot.Yaw - Previous.Yaw) * Alpha);
+		OutSnapshot.AimPitch = FMath::Clamp(NewestSnapshot.AimPitch + (NewestSnapshot.AimPitch - Previous.AimPitch) * Alpha, -90.f, 90.f);
+		return true;
+	}
+
+	//binary search for the first snapshot after Time, same as the lag compensation history
+	int32 Low = 0;
+	int32 High = NumSnapshots - 1;
+	while(Low < High){
+		const int32 Mid = (Low + High) / 2;
+		if(Snapshots[SnapshotIndex(Mid)].Time <= Time){
+			Low = Mid + 1;
+		}
+		else{
+			High = Mid;
+		}
+	}
+
+	const FProxySnapshot& Older = Snapshots[SnapshotIndex(Low - 1)];
+	const FProxySnapshot& Younger = Snapshots[SnapshotIndex(Low)];
+	const float Alpha = static_cast<float>((Time - Older.Time) / (Younger.Time - Older.Time));
+	OutSnapshot.Yaw = FRotator::NormalizeAxis(Older.Yaw + FRotator::NormalizeAxis(Younger.Yaw - Older.Yaw) * Alpha);
+	OutSnapshot.AimPitch = FMath::Lerp(Older.AimPitch, Younger.AimPitch, Alpha);
+	return true;
+}
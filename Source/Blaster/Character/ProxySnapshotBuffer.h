@@ -0,0 +1,46 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+//where a character other than our own was facing and aiming when an update about it came in
+struct FProxySnapshot
+{
+	double Time = 0.0;
+	float Yaw = 0.f;
+	float AimPitch = 0.f;
+};
+
+/**
+ * The last few snapshots of a character this machine doesn't control, in a ring buffer. Reading it a little behind the
+ * newest snapshot gives a state that moves smoothly between updates no matter how unevenly they arrive
+ */
+class BLASTER_API FProxySnapshotBuffer
+{
+public:
+
+	void Init(int32 InCapacity);
+	void Reset();
+
+	//snapshots have to come in time order, one at the same time as the newest replaces it
+	void Add(double Time, float Yaw, float AimPitch);
+
+	//state at Time, interpolated between the snapshots either side of it. Past the newest snapshot the last turn rate
+	//is carried on for up to MaxExtrapolation seconds, but never further than the last turn itself, and then eased back
+	//to the newest snapshot over the same time, so a character that stopped turning doesn't stay overshot while no new
+	//update comes in
+	bool Sample(double Time, float MaxExtrapolation, FProxySnapshot& OutSnapshot) const;
+
+	FORCEINLINE bool IsEmpty() const { return NumSnapshots == 0; }
+	const FProxySnapshot& Newest() const;
+
+private:
+
+	FORCEINLINE int32 SnapshotIndex(int32 Offset) const { return (Head - NumSnapshots + Offset + Snapshots.Num()) % Snapshots.Num(); }
+
+	TArray<FProxySnapshot> Snapshots;
+	//slot the next snapshot is written to
+	int32 Head = 0;
+	int32 NumSnapshots = 0;
+};
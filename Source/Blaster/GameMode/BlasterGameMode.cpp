@@ -5,9 +5,13 @@
 #include "Blaster/Character/BlasterCharacter.h"
 #include "Blaster/PlayerController/BlasterPlayerController.h"
 #include "Kismet/GameplayStatics.h"
-#include "GameFramework/PlayerStart.h"
 #include "Blaster/PlayerState/BlasterPlayerState.h"
 #include "Blaster/GameState/BlasterGameState.h"
+#include "Blaster/BlasterComponents/CombatComponent.h"
+#include "Blaster/Weapon/ProjectileWeapon.h"
+#include "Blaster/Weapon/Projectile.h"
+#include "Blaster/Weapon/ProjectilePoolSubsystem.h"
+#include "EngineUtils.h"
 
 namespace MatchState{
     const FName Cooldown = FName("Cooldown");
@@ -23,6 +27,25 @@ void ABlasterGameMode::BeginPlay()
 {
     Super::BeginPlay();
     LevelStartingTime = GetWorld()->GetTimeSeconds();
+
+    //player starts never move, so they are only collected once
+    SpawnPoints.Build(GetWorld(), SpawnGridCellSize, SpawnSafeDistance);
+    GetWorldTimerManager().SetTimer(SpawnRegistryTimer, this, &ThisClass::UpdateSpawnRegistry, SpawnRegistryUpdateInterval, true);
+}
+
+void ABlasterGameMode::RegisterCharacter(ABlasterCharacter *Character)
+{
+    SpawnPoints.AddCharacter(Character);
+}
+
+void ABlasterGameMode::UnregisterCharacter(ABlasterCharacter *Character)
+{
+    SpawnPoints.RemoveCharacter(Character);
+}
+
+void ABlasterGameMode::UpdateSpawnRegistry()
+{
+    SpawnPoints.UpdateCharacters();
 }
 
 void ABlasterGameMode::OnMatchStateSet()
@@ -38,6 +61,37 @@ void ABlasterGameMode::OnMatchStateSet()
     }
 }
 
+void ABlasterGameMode::HandleMatchHasStarted()
+{
+    Super::HandleMatchHasStarted();
+
+    PrewarmProjectilePool();
+}
+
+void ABlasterGameMode::PrewarmProjectilePool()
+{
+    UProjectilePoolSubsystem* ProjectilePool = GetWorld()->GetSubsystem<UProjectilePoolSubsystem>();
+    if(ProjectilePool == nullptr) {return;}
+
+    //weapons of the same class share one pool, so add up how many of each class could be in the air at once
+    TMap<TSubclassOf<AProjectile>, int32> PrewarmCounts;
+    for(TActorIterator<AProjectileWeapon> It(GetWorld()); It; ++It){
+        if(It->GetProjectileClass()){
+            PrewarmCounts.FindOrAdd(It->GetProjectileClass()) += PrewarmProjectilesPerWeapon;
+        }
+    }
+    for(TActorIterator<ABlasterCharacter> It(GetWorld()); It; ++It){
+        UCombatComponent* Combat = It->GetCombat();
+        if(Combat && Combat->GetGrenadeClass()){
+            PrewarmCounts.FindOrAdd(Combat->GetGrenadeClass()) += PrewarmGrenadesPerCharacter;
+        }
+    }
+
+    for(const TPair<TSubclassOf<AProjectile>, int32>& PrewarmCount : PrewarmCounts){
+        ProjectilePool->PrewarmProjectiles(PrewarmCount.Key, PrewarmCount.Value);
+    }
+}
+
 void ABlasterGameMode::Tick(float DeltaTime)
 {
     Super::Tick(DeltaTime);
@@ -70,12 +124,10 @@ void ABlasterGameMode::PlayerEliminated(ABlasterCharacter *ElimmedCharacter, ABl
     ABlasterPlayerState* AttackerPlayerState = AttackerController ? Cast<ABlasterPlayerState>(AttackerController->PlayerState) : nullptr;
     ABlasterPlayerState* VictimPlayerState = VictimController ? Cast<ABlasterPlayerState>(VictimController->PlayerState) : nullptr;
 
-    ABlasterGameState* BlasterGameState = GetGameState<ABlasterGameState>();
-
-    //if one character eliminated another character, add to the aggressors score
-    if(AttackerPlayerState && AttackerPlayerState != VictimPlayerState && BlasterGameState){
+    //if one character eliminated another character, add to the aggressors score. The player state keeps the
+    //leaderboard in the game state up to date
+    if(AttackerPlayerState && AttackerPlayerState != VictimPlayerState){
         AttackerPlayerState->AddToScore(1.f);
-        BlasterGameState->UpdateTopScore(AttackerPlayerState);
     }
 
     if(VictimPlayerState){
@@ -83,21 +135,52 @@ void ABlasterGameMode::PlayerEliminated(ABlasterCharacter *ElimmedCharacter, ABl
     }
 
     if(ElimmedCharacter){
+        //a body nobody controls anymore shouldn't keep players from spawning near it
+        UnregisterCharacter(ElimmedCharacter);
         ElimmedCharacter->Elim();
     }
 }
 
 void ABlasterGameMode::RequestRespawn(ACharacter *ElimmedCharacter, AController *ElimmedController)
 {
+    ABlasterCharacter* BlasterCharacter = Cast<ABlasterCharacter>(ElimmedCharacter);
+    if(bRecyclePawns && BlasterCharacter && ElimmedController){
+        AActor* StartSpot = ChooseRespawnStart();
+        if(StartSpot){
+            RecyclePawn(BlasterCharacter, ElimmedController, StartSpot);
+            return;
+        }
+    }
+
     if(ElimmedCharacter){
         ElimmedCharacter->Reset();
         ElimmedCharacter->Destroy();
     }
     if(ElimmedController){
         UE_LOG(LogTemp, Warning, TEXT("ElimmedController valid"));
-        TArray<AActor*> PlayerStarts;
-        UGameplayStatics::GetAllActorsOfClass(this, APlayerStart::StaticClass(), PlayerStarts);
-        int32 Selection = FMath::RandRange(0, PlayerStarts.Num() - 1);
-        RestartPlayerAtPlayerStart(ElimmedController, PlayerStarts[Selection]);
+        RestartPlayerAtPlayerStart(ElimmedController, ChooseRespawnStart());
     }
 }
+
+AActor* ABlasterGameMode::ChooseRespawnStart()
+{
+    //bring the registry up to date first so a player who just ran up to a start is counted
+    SpawnPoints.UpdateCharacters();
+    return SpawnPoints.ChooseStart();
+}
+
+void ABlasterGameMode::RecyclePawn(ABlasterCharacter *ElimmedCharacter, AController *ElimmedController, AActor *StartSpot)
+{
+    ElimmedCharacter->ResetForRespawn(StartSpot->GetActorLocation(), StartSpot->GetActorRotation());
+    RegisterCharacter(ElimmedCharacter);
+
+    //possessing the same pawn again runs the same restart a freshly spawned pawn gets, so input, camera and HUD health
+    //all come back the way they would after RestartPlayerAtPlayerStart
+    ElimmedController->Possess(ElimmedCharacter);
+
+    //same as the end of FinishRestartPlayer, face the way the player start faces
+    FRotator ControlRotation = StartSpot->GetActorRotation();
+    ControlRotation.Roll = 0.f;
+    ElimmedController->ClientSetRotation(ControlRotation, true);
+    ElimmedController->SetControlRotation(ControlRotation);
+}
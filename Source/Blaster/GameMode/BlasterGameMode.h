@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/GameMode.h"
+#include "SpawnPointRegistry.h"
 #include "BlasterGameMode.generated.h"
 
 namespace MatchState{
@@ -37,13 +38,55 @@ public:
 
 	float LevelStartingTime = 0.f;
 
+	//idle projectiles spawned into the pool at match start for every projectile weapon in the level
+	UPROPERTY(EditDefaultsOnly, Category = "Projectile Pool")
+	int32 PrewarmProjectilesPerWeapon = 6;
+
+	//idle grenades spawned into the pool at match start for every character
+	UPROPERTY(EditDefaultsOnly, Category = "Projectile Pool")
+	int32 PrewarmGrenadesPerCharacter = 2;
+
+	//eliminated characters are reset and moved to a player start instead of being destroyed and spawned again, which
+	//saves an actor spawn and a new replication channel on every death
+	UPROPERTY(EditDefaultsOnly, Category = "Respawn")
+	bool bRecyclePawns = true;
+
+	//respawns pick a start with nobody within this distance whenever there is one
+	UPROPERTY(EditDefaultsOnly, Category = "Respawn")
+	float SpawnSafeDistance = 2000.f;
+
+	//size of the grid cells the spawn registry tracks characters in, smaller is more precise but moves them between cells more often
+	UPROPERTY(EditDefaultsOnly, Category = "Respawn")
+	float SpawnGridCellSize = 1000.f;
+
+	//how often character positions are pushed into the spawn registry
+	UPROPERTY(EditDefaultsOnly, Category = "Respawn")
+	float SpawnRegistryUpdateInterval = 0.25f;
+
+	//live characters are kept in the spawn registry so nobody respawns next to them
+	void RegisterCharacter(ABlasterCharacter* Character);
+	void UnregisterCharacter(ABlasterCharacter* Character);
+
 	FORCEINLINE float GetCountdownTime() const {return CountdownTime;}
 
 protected:
 	virtual void BeginPlay() override;
 	virtual void OnMatchStateSet() override;
+	virtual void HandleMatchHasStarted() override;
+
+	//fills the projectile pool for every projectile and grenade class that is in play
+	void PrewarmProjectilePool();
+
+	AActor* ChooseRespawnStart();
+	void RecyclePawn(ABlasterCharacter* ElimmedCharacter, AController* ElimmedController, AActor* StartSpot);
 
 private:
 	float CountdownTime = 0.f;
 
+	FSpawnPointRegistry SpawnPoints;
+
+	FTimerHandle SpawnRegistryTimer;
+
+	void UpdateSpawnRegistry();
+
 };
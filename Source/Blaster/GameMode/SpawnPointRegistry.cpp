@@ -0,0 +1,144 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SpawnPointRegistry.h"
+#include "Blaster/Character/BlasterCharacter.h"
+#include "GameFramework/PlayerStart.h"
+#include "EngineUtils.h"
+
+void FSpawnPointRegistry::Build(UWorld* World, float InCellSize, float SafeDistance)
+{
+	CellSize = FMath::Max(InCellSize, 1.f);
+	Starts.Reset();
+	StartsNearCell.Reset();
+	SafeStarts.Reset();
+	SafeStartSlot.Reset();
+	if(World == nullptr) {return;}
+
+	for(TActorIterator<APlayerStart> It(World); It; ++It){
+		Starts.Add(*It);
+	}
+
+	//a cell is close enough if any part of it could be within SafeDistance, measured in whole cells
+	const int32 ReachCells = FMath::CeilToInt(SafeDistance / CellSize);
+	for(int32 StartIndex = 0; StartIndex < Starts.Num(); ++StartIndex){
+		const FIntPoint StartCell = CellOf(Starts[StartIndex]->GetActorLocation());
+		for(int32 X = -ReachCells; X <= ReachCells; ++X){
+			for(int32 Y = -ReachCells; Y <= ReachCells; ++Y){
+				StartsNearCell.FindOrAdd(StartCell + FIntPoint(X, Y)).Add(StartIndex);
+			}
+		}
+	}
+
+	StartThreat.Init(0, Starts.Num());
+	SafeStartSlot.Init(INDEX_NONE, Starts.Num());
+	for(int32 StartIndex = 0; StartIndex < Starts.Num(); ++StartIndex){
+		SafeStartSlot[StartIndex] = SafeStarts.Add(StartIndex);
+	}
+
+	//characters that showed up before the registry was built still count
+	for(FTrackedCharacter& Tracked : Characters){
+		if(Tracked.Character.IsValid()){
+			Tracked.Cell = CellOf(Tracked.Character->GetActorLocation());
+			AddThreat(Tracked.Cell, 1);
+		}
+	}
+}
+
+void FSpawnPointRegistry::AddCharacter(ABlasterCharacter* Character)
+{
+	if(Character == nullptr) {return;}
+	for(const FTrackedCharacter& Tracked : Characters){
+		if(Tracked.Character.Get() == Character) {return;}
+	}
+
+	FTrackedCharacter& Tracked = Characters.AddDefaulted_GetRef();
+	Tracked.Character = Character;
+	Tracked.Cell = CellOf(Character->GetActorLocation());
+	AddThreat(Tracked.Cell, 1);
+}
+
+void FSpawnPointRegistry::RemoveCharacter(ABlasterCharacter* Character)
+{
+	for(int32 Index = 0; Index < Characters.Num(); ++Index){
+		if(Characters[Index].Character.Get() == Character){
+			AddThreat(Characters[Index].Cell, -1);
+			Characters.RemoveAtSwap(Index);
+			return;
+		}
+	}
+}
+
+void FSpawnPointRegistry::UpdateCharacters()
+{
+	for(int32 Index = Characters.Num() - 1; Index >= 0; --Index){
+		FTrackedCharacter& Tracked = Characters[Index];
+		//anything destroyed without being removed stops counting here
+		if(!Tracked.Character.IsValid()){
+			AddThreat(Tracked.Cell, -1);
+			Characters.RemoveAtSwap(Index);
+			continue;
+		}
+
+		const FIntPoint Cell = CellOf(Tracked.Character->GetActorLocation());
+		if(Cell != Tracked.Cell){
+			AddThreat(Tracked.Cell, -1);
+			AddThreat(Cell, 1);
+			Tracked.Cell = Cell;
+		}
+	}
+}
+
+AActor* FSpawnPointRegistry::ChooseStart() const
+{
+	if(SafeStarts.Num() > 0){
+		return Starts[SafeStarts[FMath::RandRange(0, SafeStarts.Num() - 1)]].Get();
+	}
+
+	//everywhere is contested, so take the start with the fewest characters around it. Ties are broken at random by
+	//counting how many have been seen so far
+	int32 BestStart = INDEX_NONE;
+	int32 NumTied = 0;
+	for(int32 StartIndex = 0; StartIndex < Starts.Num(); ++StartIndex){
+		if(!Starts[StartIndex].IsValid()) {continue;}
+		if(BestStart == INDEX_NONE || StartThreat[StartIndex] < StartThreat[BestStart]){
+			BestStart = StartIndex;
+			NumTied = 1;
+		}
+		else if(StartThreat[StartIndex] == StartThreat[BestStart] && FMath::RandRange(0, NumTied++) == 0){
+			BestStart = StartIndex;
+		}
+	}
+	return BestStart != INDEX_NONE ? Starts[BestStart].Get() : nullptr;
+}
+
+FIntPoint FSpawnPointRegistry::CellOf(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize));
+}
+
+void FSpawnPointRegistry::AddThreat(const FIntPoint& Cell, int32 Delta)
+{
+	const TArray<int32>* NearbyStarts = StartsNearCell.Find(Cell);
+	if(NearbyStarts == nullptr) {return;}
+
+	for(const int32 StartIndex : *NearbyStarts){
+		const bool bWasSafe = StartThreat[StartIndex] == 0;
+		StartThreat[StartIndex] += Delta;
+		const bool bIsSafe = StartThreat[StartIndex] == 0;
+
+		if(bWasSafe && !bIsSafe){
+			//swap the last safe start into this one's slot
+			const int32 Slot = SafeStartSlot[StartIndex];
+			const int32 MovedStart = SafeStarts.Last();
+			SafeStarts.RemoveAtSwap(Slot);
+			if(MovedStart != StartIndex){
+				SafeStartSlot[MovedStart] = Slot;
+			}
+			SafeStartSlot[StartIndex] = INDEX_NONE;
+		}
+		else if(!bWasSafe && bIsSafe){
+			SafeStartSlot[StartIndex] = SafeStarts.Add(StartIndex);
+		}
+	}
+}
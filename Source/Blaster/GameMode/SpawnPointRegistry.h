@@ -0,0 +1,63 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AActor;
+class ABlasterCharacter;
+
+/**
+ * Every player start in the level, collected once, plus a coarse 2D grid of where the live characters are. Each start
+ * keeps a count of the characters within SafeDistance of it, which is updated only when a character crosses into a
+ * new cell, so picking a start never has to look at every character or walk the world for actors
+ */
+class BLASTER_API FSpawnPointRegistry
+{
+public:
+
+	//collects the player starts and works out which grid cells are close enough to threaten each one
+	void Build(UWorld* World, float InCellSize, float SafeDistance);
+
+	//live characters count as threats to the starts around them. Eliminated characters should be removed
+	void AddCharacter(ABlasterCharacter* Character);
+	void RemoveCharacter(ABlasterCharacter* Character);
+
+	//moves characters that have crossed into a new cell since the last update
+	void UpdateCharacters();
+
+	//a random start nobody is near, or the least threatened one if every start has someone near it
+	AActor* ChooseStart() const;
+
+	FORCEINLINE int32 NumStarts() const { return Starts.Num(); }
+	FORCEINLINE int32 NumSafeStarts() const { return SafeStarts.Num(); }
+
+private:
+
+	struct FTrackedCharacter
+	{
+		TWeakObjectPtr<ABlasterCharacter> Character;
+		FIntPoint Cell;
+	};
+
+	FIntPoint CellOf(const FVector& Location) const;
+
+	//adds Delta threat to every start within reach of Cell and keeps SafeStarts in step
+	void AddThreat(const FIntPoint& Cell, int32 Delta);
+
+	float CellSize = 1000.f;
+
+	TArray<TWeakObjectPtr<AActor>> Starts;
+
+	//characters within SafeDistance of each start, same order as Starts
+	TArray<int32> StartThreat;
+
+	//for each cell, the starts that a character standing in it threatens
+	TMap<FIntPoint, TArray<int32>> StartsNearCell;
+
+	//starts with no threat, and where each start is in that array or INDEX_NONE, so moving a start in or out is O(1)
+	TArray<int32> SafeStarts;
+	TArray<int32> SafeStartSlot;
+
+	TArray<FTrackedCharacter> Characters;
+};
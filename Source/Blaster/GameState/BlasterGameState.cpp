@@ -9,21 +9,35 @@ void ABlasterGameState::GetLifetimeReplicatedProps(TArray<FLifetimeProperty> &Ou
 {
     Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-    DOREPLIFETIME(ABlasterGameState, TopScoringPlayers);
+    DOREPLIFETIME(ABlasterGameState, Leaderboard);
 }
 
-void ABlasterGameState::UpdateTopScore(ABlasterPlayerState *ScoringPlayer)
+void ABlasterGameState::AddPlayerState(APlayerState *PlayerState)
 {
-    if(TopScoringPlayers.Num() == 0){
-        TopScoringPlayers.Add(ScoringPlayer);
-        TopScore = ScoringPlayer->GetScore();
-    }
-    else if(ScoringPlayer->GetScore() == TopScore){
-        TopScoringPlayers.AddUnique(ScoringPlayer);
+    Super::AddPlayerState(PlayerState);
+
+    //clients get the rows through replication, this also gets called on them when a player state shows up
+    if(HasAuthority()){
+        Leaderboard.AddPlayer(Cast<ABlasterPlayerState>(PlayerState));
     }
-    else if(ScoringPlayer->GetScore() > TopScore){
-        TopScoringPlayers.Empty();
-        TopScoringPlayers.AddUnique(ScoringPlayer);
-        TopScore = ScoringPlayer->GetScore();
+}
+
+void ABlasterGameState::RemovePlayerState(APlayerState *PlayerState)
+{
+    if(HasAuthority()){
+        Leaderboard.RemovePlayer(Cast<ABlasterPlayerState>(PlayerState));
     }
+
+    Super::RemovePlayerState(PlayerState);
+}
+
+void ABlasterGameState::UpdateLeaderboard(ABlasterPlayerState *Player)
+{
+    if(Player == nullptr) {return;}
+    Leaderboard.UpdatePlayer(Player, Player->GetScore(), Player->GetDefeats(), Player->GetKillStreak());
+}
+
+void ABlasterGameState::GetTopScoringPlayers(TArray<ABlasterPlayerState*> &OutPlayers) const
+{
+    Leaderboard.GetTopScoringPlayers(OutPlayers);
 }
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/GameState.h"
+#include "Leaderboard.h"
 #include "BlasterGameState.generated.h"
 
 /**
@@ -16,13 +17,20 @@ class BLASTER_API ABlasterGameState : public AGameState
 
 public:
 	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
-	void UpdateTopScore(class ABlasterPlayerState* ScoringPlayer);
 
-	UPROPERTY(Replicated)
-	TArray<ABlasterPlayerState*> TopScoringPlayers;
+	virtual void AddPlayerState(APlayerState* PlayerState) override;
+	virtual void RemovePlayerState(APlayerState* PlayerState) override;
+
+	//called on the server whenever a player's score, defeats or kill streak changes
+	void UpdateLeaderboard(class ABlasterPlayerState* Player);
+
+	void GetTopScoringPlayers(TArray<ABlasterPlayerState*>& OutPlayers) const;
+
+	FORCEINLINE const FLeaderboard& GetLeaderboard() const { return Leaderboard; }
 
 private:
 
-	float TopScore = 0.f;
+	UPROPERTY(Replicated)
+	FLeaderboard Leaderboard;
 
 };
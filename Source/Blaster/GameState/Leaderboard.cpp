@@ -0,0 +1,277 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Leaderboard.h"
+#include "Blaster/PlayerState/BlasterPlayerState.h"
+#include "Algo/StableSort.h"
+#include "Templates/TypeHash.h"
+
+bool FLeaderboardEntry::RanksAbove(const FLeaderboardEntry& Other) const
+{
+	if(Score != Other.Score) {return Score > Other.Score;}
+	return Defeats < Other.Defeats;
+}
+
+void FLeaderboardEntry::PostReplicatedAdd(const FLeaderboard& InArraySerializer)
+{
+	InArraySerializer.MarkRankOrderDirty();
+}
+
+void FLeaderboardEntry::PostReplicatedChange(const FLeaderboard& InArraySerializer)
+{
+	InArraySerializer.MarkRankOrderDirty();
+}
+
+void FLeaderboardEntry::PreReplicatedRemove(const FLeaderboard& InArraySerializer)
+{
+	InArraySerializer.MarkRankOrderDirty();
+}
+
+void FLeaderboard::AddPlayer(ABlasterPlayerState* PlayerState)
+{
+	if(PlayerState == nullptr || GetRank(PlayerState) != INDEX_NONE) {return;}
+
+	FLeaderboardEntry& Entry = Entries.AddDefaulted_GetRef();
+	Entry.PlayerState = PlayerState;
+	Entry.Score = PlayerState->GetScore();
+	Entry.Defeats = PlayerState->GetDefeats();
+	Entry.KillStreak = PlayerState->GetKillStreak();
+	MarkItemDirty(Entry);
+
+	const int32 EntryIndex = Entries.Num() - 1;
+	EntryIndexByPlayer.Add(PlayerState, EntryIndex);
+	RankNodes.AddDefaulted();
+	ResetNode(EntryIndex);
+	InsertNode(EntryIndex);
+}
+
+void FLeaderboard::RemovePlayer(ABlasterPlayerState* PlayerState)
+{
+	EnsureRankOrder();
+	const int32* EntryIndex = EntryIndexByPlayer.Find(PlayerState);
+	if(EntryIndex == nullptr) {return;}
+
+	//every entry after this one shifts down, which is rare enough (players leaving) to just rebuild the tree for
+	Entries.RemoveAt(*EntryIndex);
+	MarkArrayDirty();
+	MarkRankOrderDirty();
+}
+
+void FLeaderboard::UpdatePlayer(ABlasterPlayerState* PlayerState, float Score, int32 Defeats, int32 KillStreak)
+{
+	EnsureRankOrder();
+	if(!EntryIndexByPlayer.Contains(PlayerState)){
+		AddPlayer(PlayerState);
+	}
+	const int32* EntryIndex = EntryIndexByPlayer.Find(PlayerState);
+	if(EntryIndex == nullptr) {return;}
+
+	FLeaderboardEntry& Entry = Entries[*EntryIndex];
+	if(Entry.Score == Score && Entry.Defeats == Defeats && Entry.KillStreak == KillStreak) {return;}
+
+	Entry.Score = Score;
+	Entry.Defeats = Defeats;
+	Entry.KillStreak = KillStreak;
+	MarkItemDirty(Entry);
+	Reposition(*EntryIndex);
+}
+
+const FLeaderboardEntry& FLeaderboard::GetEntryAtRank(int32 Rank) const
+{
+	EnsureRankOrder();
+	check(Rank >= 0 && Rank < Entries.Num());
+
+	int32 Node = RankRoot;
+	while(true){
+		const int32 LeftSize = SubtreeSize(RankNodes[Node].Left);
+		if(Rank < LeftSize){
+			Node = RankNodes[Node].Left;
+		}
+		else if(Rank == LeftSize){
+			return Entries[Node];
+		}
+		else{
+			Rank -= LeftSize + 1;
+			Node = RankNodes[Node].Right;
+		}
+	}
+}
+
+int32 FLeaderboard::GetRank(const ABlasterPlayerState* PlayerState) const
+{
+	EnsureRankOrder();
+	const int32* EntryIndex = EntryIndexByPlayer.Find(PlayerState);
+	if(EntryIndex == nullptr) {return INDEX_NONE;}
+
+	//everything in the left subtree ranks above, and so does every ancestor we come up to from the right with its left subtree
+	int32 Node = *EntryIndex;
+	int32 Rank = SubtreeSize(RankNodes[Node].Left);
+	while(RankNodes[Node].Parent != INDEX_NONE){
+		const int32 Parent = RankNodes[Node].Parent;
+		if(RankNodes[Parent].Right == Node){
+			Rank += SubtreeSize(RankNodes[Parent].Left) + 1;
+		}
+		Node = Parent;
+	}
+	return Rank;
+}
+
+void FLeaderboard::GetTopScoringPlayers(TArray<ABlasterPlayerState*>& OutPlayers) const
+{
+	OutPlayers.Reset();
+	EnsureRankOrder();
+	if(Entries.Num() == 0) {return;}
+
+	const float TopScore = GetEntryAtRank(0).Score;
+	if(TopScore <= 0.f) {return;}
+	for(int32 Rank = 0; Rank < Entries.Num(); ++Rank){
+		const FLeaderboardEntry& Entry = GetEntryAtRank(Rank);
+		if(Entry.Score != TopScore) {break;}
+		if(Entry.PlayerState){
+			OutPlayers.Add(Entry.PlayerState);
+		}
+	}
+}
+
+void FLeaderboard::EnsureRankOrder() const
+{
+	if(bRankOrderDirty || RankNodes.Num() != Entries.Num()){
+		RebuildRankOrder();
+	}
+}
+
+void FLeaderboard::RebuildRankOrder() const
+{
+	TArray<int32> RankOrder;
+	RankOrder.SetNumUninitialized(Entries.Num());
+	for(int32 EntryIndex = 0; EntryIndex < Entries.Num(); ++EntryIndex){
+		RankOrder[EntryIndex] = EntryIndex;
+	}
+	Algo::StableSort(RankOrder, [this](int32 A, int32 B){ return Entries[A].RanksAbove(Entries[B]); });
+
+	//stamped in rank order, so ties keep the order the sort left them in
+	RankNodes.SetNum(Entries.Num());
+	RankRoot = INDEX_NONE;
+	EntryIndexByPlayer.Reset();
+	for(const int32 EntryIndex : RankOrder){
+		ResetNode(EntryIndex);
+		InsertNode(EntryIndex);
+		EntryIndexByPlayer.Add(Entries[EntryIndex].PlayerState, EntryIndex);
+	}
+	bRankOrderDirty = false;
+}
+
+void FLeaderboard::Reposition(int32 EntryIndex)
+{
+	//a full rebuild already puts this entry in the right place
+	if(bRankOrderDirty || RankNodes.Num() != Entries.Num()){
+		RebuildRankOrder();
+		return;
+	}
+
+	//entries it only ties with stay ahead of it, since they got there first
+	RemoveNode(EntryIndex);
+	ResetNode(EntryIndex);
+	InsertNode(EntryIndex);
+}
+
+bool FLeaderboard::RanksBefore(int32 A, int32 B) const
+{
+	if(Entries[A].RanksAbove(Entries[B])) {return true;}
+	if(Entries[B].RanksAbove(Entries[A])) {return false;}
+	return RankNodes[A].Stamp < RankNodes[B].Stamp;
+}
+
+void FLeaderboard::ResetNode(int32 Node) const
+{
+	FRankNode& RankNode = RankNodes[Node];
+	RankNode = FRankNode();
+	RankNode.Stamp = NextStamp++;
+	RankNode.Priority = MurmurFinalize32(RankNode.Stamp);
+}
+
+void FLeaderboard::InsertNode(int32 Node) const
+{
+	int32 Before = INDEX_NONE;
+	int32 After = INDEX_NONE;
+	SplitBefore(RankRoot, Node, Before, After);
+	SetRoot(Merge(Merge(Before, Node), After));
+}
+
+void FLeaderboard::RemoveNode(int32 Node) const
+{
+	//everything on the left ranks above everything on the right, so the two subtrees merge straight into its place
+	const int32 Replacement = Merge(RankNodes[Node].Left, RankNodes[Node].Right);
+	const int32 Parent = RankNodes[Node].Parent;
+	if(Parent == INDEX_NONE){
+		SetRoot(Replacement);
+		return;
+	}
+
+	if(RankNodes[Parent].Left == Node){
+		SetChildren(Parent, Replacement, RankNodes[Parent].Right);
+	}
+	else{
+		SetChildren(Parent, RankNodes[Parent].Left, Replacement);
+	}
+	for(int32 Ancestor = RankNodes[Parent].Parent; Ancestor != INDEX_NONE; Ancestor = RankNodes[Ancestor].Parent){
+		RankNodes[Ancestor].Size--;
+	}
+}
+
+void FLeaderboard::SplitBefore(int32 Root, int32 Key, int32& OutBefore, int32& OutAfter) const
+{
+	if(Root == INDEX_NONE){
+		OutBefore = INDEX_NONE;
+		OutAfter = INDEX_NONE;
+		return;
+	}
+
+	if(RanksBefore(Root, Key)){
+		int32 RightBefore = INDEX_NONE;
+		SplitBefore(RankNodes[Root].Right, Key, RightBefore, OutAfter);
+		SetChildren(Root, RankNodes[Root].Left, RightBefore);
+		OutBefore = Root;
+	}
+	else{
+		int32 LeftAfter = INDEX_NONE;
+		SplitBefore(RankNodes[Root].Left, Key, OutBefore, LeftAfter);
+		SetChildren(Root, LeftAfter, RankNodes[Root].Right);
+		OutAfter = Root;
+	}
+}
+
+int32 FLeaderboard::Merge(int32 Before, int32 After) const
+{
+	if(Before == INDEX_NONE) {return After;}
+	if(After == INDEX_NONE) {return Before;}
+
+	if(RankNodes[Before].Priority > RankNodes[After].Priority){
+		SetChildren(Before, RankNodes[Before].Left, Merge(RankNodes[Before].Right, After));
+		return Before;
+	}
+	SetChildren(After, Merge(Before, RankNodes[After].Left), RankNodes[After].Right);
+	return After;
+}
+
+void FLeaderboard::SetChildren(int32 Node, int32 Left, int32 Right) const
+{
+	FRankNode& RankNode = RankNodes[Node];
+	RankNode.Left = Left;
+	RankNode.Right = Right;
+	RankNode.Size = 1 + SubtreeSize(Left) + SubtreeSize(Right);
+	if(Left != INDEX_NONE){
+		RankNodes[Left].Parent = Node;
+	}
+	if(Right != INDEX_NONE){
+		RankNodes[Right].Parent = Node;
+	}
+}
+
+void FLeaderboard::SetRoot(int32 Node) const
+{
+	RankRoot = Node;
+	if(Node != INDEX_NONE){
+		RankNodes[Node].Parent = INDEX_NONE;
+	}
+}
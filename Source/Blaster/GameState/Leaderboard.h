@@ -0,0 +1,137 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Net/Serialization/FastArraySerializer.h"
+#include "Leaderboard.generated.h"
+
+class ABlasterPlayerState;
+struct FLeaderboard;
+
+//one player's row. Only rows that changed are sent to clients
+USTRUCT(BlueprintType)
+struct FLeaderboardEntry : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly)
+	ABlasterPlayerState* PlayerState = nullptr;
+
+	UPROPERTY(BlueprintReadOnly)
+	float Score = 0.f;
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 Defeats = 0;
+
+	//eliminations since this player was last eliminated
+	UPROPERTY(BlueprintReadOnly)
+	int32 KillStreak = 0;
+
+	//higher score first, fewer defeats breaks a tie
+	bool RanksAbove(const FLeaderboardEntry& Other) const;
+
+	void PostReplicatedAdd(const FLeaderboard& InArraySerializer);
+	void PostReplicatedChange(const FLeaderboard& InArraySerializer);
+	void PreReplicatedRemove(const FLeaderboard& InArraySerializer);
+};
+
+/**
+ * Every player's score, defeats and kill streak, replicated as a fast array so a change only sends that player's row.
+ * The server keeps the rows in a rank tree as they change, so moving a row, finding a player's rank and finding the
+ * row at a rank are all O(log n). Clients don't get the order, they rebuild the tree from their copy the next time it
+ * is asked for after a change
+ */
+USTRUCT()
+struct FLeaderboard : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FLeaderboardEntry, FLeaderboard>(Entries, DeltaParms, *this);
+	}
+
+	/**
+	 * Server only
+	 */
+
+	void AddPlayer(ABlasterPlayerState* PlayerState);
+	void RemovePlayer(ABlasterPlayerState* PlayerState);
+	void UpdatePlayer(ABlasterPlayerState* PlayerState, float Score, int32 Defeats, int32 KillStreak);
+
+	/**
+	 * Anywhere
+	 */
+
+	FORCEINLINE int32 Num() const { return Entries.Num(); }
+
+	//Rank 0 is first place
+	const FLeaderboardEntry& GetEntryAtRank(int32 Rank) const;
+	//INDEX_NONE if the player isn't on the board
+	int32 GetRank(const ABlasterPlayerState* PlayerState) const;
+
+	//everyone tied for first, or nobody if nobody has scored
+	void GetTopScoringPlayers(TArray<ABlasterPlayerState*>& OutPlayers) const;
+
+	//set from the replication callbacks so the order is rebuilt the next time it's read
+	void MarkRankOrderDirty() const { bRankOrderDirty = true; }
+
+private:
+
+	UPROPERTY()
+	TArray<FLeaderboardEntry> Entries;
+
+	void RebuildRankOrder() const;
+	void EnsureRankOrder() const;
+
+	//moves the entry to where its current values belong
+	void Reposition(int32 EntryIndex);
+
+	/**
+	 * Rank tree
+	 * A treap over the entry indices in rank order where every node knows the size of its subtree, so a rank is
+	 * counted on the way from a node up to the root and the entry at a rank is found on the way down. Nodes are
+	 * indexed like Entries
+	 */
+
+	struct FRankNode
+	{
+		int32 Left = INDEX_NONE;
+		int32 Right = INDEX_NONE;
+		int32 Parent = INDEX_NONE;
+		int32 Size = 1;
+		//heap order that keeps the tree balanced, a hash of Stamp
+		uint32 Priority = 0;
+		//breaks ties. An entry that reached its values later ranks below the ones that were there first
+		uint32 Stamp = 0;
+	};
+
+	//true if entry A ranks above entry B, ties included
+	bool RanksBefore(int32 A, int32 B) const;
+	FORCEINLINE int32 SubtreeSize(int32 Node) const { return Node == INDEX_NONE ? 0 : RankNodes[Node].Size; }
+
+	void ResetNode(int32 Node) const;
+	void InsertNode(int32 Node) const;
+	//takes the node out wherever it is, its entry's values may already have changed
+	void RemoveNode(int32 Node) const;
+	void SplitBefore(int32 Root, int32 Key, int32& OutBefore, int32& OutAfter) const;
+	int32 Merge(int32 Before, int32 After) const;
+	void SetChildren(int32 Node, int32 Left, int32 Right) const;
+	void SetRoot(int32 Node) const;
+
+	mutable TArray<FRankNode> RankNodes;
+	mutable int32 RankRoot = INDEX_NONE;
+	mutable uint32 NextStamp = 0;
+	mutable TMap<const ABlasterPlayerState*, int32> EntryIndexByPlayer;
+	mutable bool bRankOrderDirty = false;
+};
+
+template<>
+struct TStructOpsTypeTraits<FLeaderboard> : public TStructOpsTypeTraitsBase2<FLeaderboard>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
@@ -2,4 +2,19 @@
 
 
 #include "Announcement.h"
+#include "CharacterOverlay.h"
+#include "Components/InvalidationBox.h"
 
+void UAnnouncement::NativeConstruct()
+{
+	Super::NativeConstruct();
+
+	UpdatePanelCaching();
+}
+
+void UAnnouncement::UpdatePanelCaching()
+{
+	if(StaticPanel){
+		StaticPanel->SetCanCache(UCharacterOverlay::ShouldCachePanels());
+	}
+}
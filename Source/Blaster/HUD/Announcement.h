@@ -15,6 +15,11 @@ class BLASTER_API UAnnouncement : public UUserWidget
 	GENERATED_BODY()
 
 public:
+	void UpdatePanelCaching();
+
+	//everything but the warmup timer, which only changes once a second and sits outside the panel
+	UPROPERTY(meta = (BindWidgetOptional))
+	class UInvalidationBox* StaticPanel;
 
 	UPROPERTY(meta = (BindWidget))
 	class UTextBlock* WarmupTime;
@@ -24,5 +29,7 @@ public:
 
 	UPROPERTY(meta = (BindWidget))
 	UTextBlock* InfoText;
-	
+
+protected:
+	virtual void NativeConstruct() override;
 };
@@ -5,39 +5,81 @@
 #include "GameFramework/PlayerController.h"
 #include "CharacterOverlay.h"
 #include "Announcement.h"
+#include "Engine/Canvas.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "UnrealClient.h"
 
 void ABlasterHUD::DrawHUD()
 {
     Super::DrawHUD();
 
-    FVector2D ViewportSize;
-    if(GEngine){
-        GEngine->GameViewport->GetViewportSize(ViewportSize);
-        const FVector2D ViewportCenter(ViewportSize.X / 2.f, ViewportSize.Y / 2.f);
+    if(HUDPackage == nullptr || Canvas == nullptr) {return;}
 
-        float SpreadScaled = CrosshairSpreadMax * HUDPackage.CrosshairSpread;
+    //the canvas is the size of the viewport, so this only has to be worked out again after a resize
+    if(!bViewportCenterValid){
+        ViewportCenter = FVector2D(Canvas->SizeX / 2.f, Canvas->SizeY / 2.f);
+        bViewportCenterValid = true;
+    }
 
-        if(HUDPackage.CrosshairCenter){
-            FVector2D Spread(0.f, 0.f);
-            DrawCrosshair(HUDPackage.CrosshairCenter, ViewportCenter, Spread, HUDPackage.CrosshairColor);
-        }
-        if(HUDPackage.CrosshairLeft){
-            FVector2D Spread(-SpreadScaled, 0.f);
-            DrawCrosshair(HUDPackage.CrosshairLeft, ViewportCenter, Spread, HUDPackage.CrosshairColor);
-        }
-        if(HUDPackage.CrosshairRight){
-            FVector2D Spread(SpreadScaled, 0.f);
-            DrawCrosshair(HUDPackage.CrosshairRight, ViewportCenter, Spread, HUDPackage.CrosshairColor);
-        }
-        if(HUDPackage.CrosshairTop){
-            FVector2D Spread(0.f, -SpreadScaled);
-            DrawCrosshair(HUDPackage.CrosshairTop, ViewportCenter, Spread, HUDPackage.CrosshairColor);
-        }
-        if(HUDPackage.CrosshairBottom){
-            FVector2D Spread(0.f, SpreadScaled);
-            DrawCrosshair(HUDPackage.CrosshairBottom, ViewportCenter, Spread, HUDPackage.CrosshairColor);
+    const FHUDPackage& Package = *HUDPackage;
+    float SpreadScaled = CrosshairSpreadMax * Package.CrosshairSpread;
+
+    if(CrosshairMaterial){
+        DrawCrosshairMaterial(Package, SpreadScaled);
+        return;
+    }
+
+    if(Package.CrosshairCenter){
+        FVector2D Spread(0.f, 0.f);
+        DrawCrosshair(Package.CrosshairCenter, ViewportCenter, Spread, Package.CrosshairColor);
+    }
+    if(Package.CrosshairLeft){
+        FVector2D Spread(-SpreadScaled, 0.f);
+        DrawCrosshair(Package.CrosshairLeft, ViewportCenter, Spread, Package.CrosshairColor);
+    }
+    if(Package.CrosshairRight){
+        FVector2D Spread(SpreadScaled, 0.f);
+        DrawCrosshair(Package.CrosshairRight, ViewportCenter, Spread, Package.CrosshairColor);
+    }
+    if(Package.CrosshairTop){
+        FVector2D Spread(0.f, -SpreadScaled);
+        DrawCrosshair(Package.CrosshairTop, ViewportCenter, Spread, Package.CrosshairColor);
+    }
+    if(Package.CrosshairBottom){
+        FVector2D Spread(0.f, SpreadScaled);
+        DrawCrosshair(Package.CrosshairBottom, ViewportCenter, Spread, Package.CrosshairColor);
+    }
+}
+
+void ABlasterHUD::DrawCrosshairMaterial(const FHUDPackage& Package, float SpreadScaled)
+{
+    if(CrosshairMaterialInstance == nullptr){
+        CrosshairMaterialInstance = UMaterialInstanceDynamic::Create(CrosshairMaterial, this);
+    }
+
+    //no crosshair textures means no weapon, and no weapon means no crosshair
+    UTexture2D* Textures[5] = { Package.CrosshairCenter, Package.CrosshairLeft, Package.CrosshairRight, Package.CrosshairTop, Package.CrosshairBottom };
+    static const FName TextureParameters[5] = { TEXT("Center"), TEXT("Left"), TEXT("Right"), TEXT("Top"), TEXT("Bottom") };
+    bool bAnyTexture = false;
+    for(int32 Index = 0; Index < 5; ++Index){
+        bAnyTexture |= Textures[Index] != nullptr;
+        if(Textures[Index] != CrosshairMaterialTextures[Index]){
+            CrosshairMaterialTextures[Index] = Textures[Index];
+            CrosshairMaterialInstance->SetTextureParameterValue(TextureParameters[Index], Textures[Index]);
         }
     }
+    if(!bAnyTexture) {return;}
+
+    CrosshairMaterialInstance->SetScalarParameterValue(TEXT("Spread"), SpreadScaled / CrosshairMaterialSize);
+    CrosshairMaterialInstance->SetVectorParameterValue(TEXT("Color"), Package.CrosshairColor);
+
+    const float HalfSize = CrosshairMaterialSize / 2.f;
+    DrawMaterial(CrosshairMaterialInstance, ViewportCenter.X - HalfSize, ViewportCenter.Y - HalfSize, CrosshairMaterialSize, CrosshairMaterialSize, 0.f, 0.f, 1.f, 1.f);
+}
+
+void ABlasterHUD::OnViewportResized(FViewport* Viewport, uint32 Unused)
+{
+    bViewportCenterValid = false;
 }
 
 void ABlasterHUD::AddAnnouncement()
@@ -52,6 +94,15 @@ void ABlasterHUD::AddAnnouncement()
 void ABlasterHUD::BeginPlay()
 {
     Super::BeginPlay();
+
+    FViewport::ViewportResizedEvent.AddUObject(this, &ThisClass::OnViewportResized);
+}
+
+void ABlasterHUD::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    FViewport::ViewportResizedEvent.RemoveAll(this);
+
+    Super::EndPlay(EndPlayReason);
 }
 
 void ABlasterHUD::AddCharacterOverlay()
@@ -60,10 +111,11 @@ void ABlasterHUD::AddCharacterOverlay()
     if(PlayerController && CharacterOverlayClass){
         CharacterOverlay = CreateWidget<UCharacterOverlay>(PlayerController, CharacterOverlayClass);
         CharacterOverlay->AddToViewport();
+        OnCharacterOverlayCreated.Broadcast(CharacterOverlay);
     }
 }
 
-void ABlasterHUD::DrawCrosshair(UTexture2D *Texture, FVector2D ViewportCenter, FVector2D Spread, FLinearColor CrosshairColor)
+void ABlasterHUD::DrawCrosshair(UTexture2D *Texture, FVector2D Center, FVector2D Spread, FLinearColor CrosshairColor)
 {
     //this will draw the texture in the center of the HUD
     //by default, drawing a texture2d will draw it to the top left of the center, so it will look odd without this
@@ -71,7 +123,7 @@ void ABlasterHUD::DrawCrosshair(UTexture2D *Texture, FVector2D ViewportCenter, F
     //depending on the offset of the texture being drawn
     const float TextureWidth = Texture->GetSizeX();
     const float TextureHeight = Texture->GetSizeY();
-    const FVector2D TextureDrawPoint(ViewportCenter.X - (TextureWidth / 2.f) + Spread.X, ViewportCenter.Y - (TextureHeight / 2.f) + Spread.Y);
+    const FVector2D TextureDrawPoint(Center.X - (TextureWidth / 2.f) + Spread.X, Center.Y - (TextureHeight / 2.f) + Spread.Y);
 
     DrawTexture(Texture, TextureDrawPoint.X, TextureDrawPoint.Y, TextureWidth, TextureHeight, 0.f, 0.f, 1.f, 1.f, CrosshairColor);
 }
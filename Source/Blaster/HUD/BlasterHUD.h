@@ -24,6 +24,8 @@ public:
 
 
 
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnCharacterOverlayCreated, class UCharacterOverlay*);
+
 /**
  * 
  */
@@ -40,6 +42,9 @@ public:
 
 	void AddCharacterOverlay();
 
+	//broadcast once the overlay has been created and added to the viewport
+	FOnCharacterOverlayCreated OnCharacterOverlayCreated;
+
 	UPROPERTY()
 	class UCharacterOverlay* CharacterOverlay;
 
@@ -54,15 +59,45 @@ public:
 protected:
 
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 private:
-	FHUDPackage HUDPackage;
+	//read only view of the package the combat component keeps up to date, so nothing gets copied every frame
+	const FHUDPackage* HUDPackage = nullptr;
 
-	void DrawCrosshair(UTexture2D* Texture, FVector2D ViewportCenter, FVector2D Spread, FLinearColor CrosshairColor);
+	void DrawCrosshair(UTexture2D* Texture, FVector2D Center, FVector2D Spread, FLinearColor CrosshairColor);
+	void DrawCrosshairMaterial(const FHUDPackage& Package, float SpreadScaled);
 
 	UPROPERTY(EditAnywhere)
 	float CrosshairSpreadMax = 16.f;
 
+	/**
+	 * Material crosshair
+	 * With a material set, the whole crosshair is one quad. The material gets the five textures as Center, Left, Right,
+	 * Top and Bottom, the spread in UV units as Spread and the color as Color
+	 */
+
+	UPROPERTY(EditAnywhere, Category = "Crosshair")
+	class UMaterialInterface* CrosshairMaterial;
+
+	//size in pixels of the quad the material is drawn on
+	UPROPERTY(EditAnywhere, Category = "Crosshair")
+	float CrosshairMaterialSize = 128.f;
+
+	UPROPERTY()
+	class UMaterialInstanceDynamic* CrosshairMaterialInstance;
+
+	//textures currently set on the material instance so they are only set when the weapon changes
+	UTexture2D* CrosshairMaterialTextures[5] = {};
+
+	//only recomputed when the viewport is resized
+	FVector2D ViewportCenter = FVector2D::ZeroVector;
+	bool bViewportCenterValid = false;
+	void OnViewportResized(class FViewport* Viewport, uint32 Unused);
+
 public:
-	FORCEINLINE void SetHUDPackage(const FHUDPackage& Package) { HUDPackage = Package; }
+	//the controlled character's combat component points the HUD at its package when it takes the HUD over, and clears
+	//it when it goes away
+	FORCEINLINE void SetHUDPackage(const FHUDPackage* Package) { HUDPackage = Package; }
+	FORCEINLINE const FHUDPackage* GetHUDPackage() const { return HUDPackage; }
 };
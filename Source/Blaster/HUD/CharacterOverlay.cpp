@@ -2,4 +2,45 @@
 
 
 #include "CharacterOverlay.h"
+#include "Components/InvalidationBox.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/UObjectIterator.h"
+#include "Announcement.h"
 
+static int32 GCacheHUDOverlay = 1;
+static FAutoConsoleVariableRef CVarCacheHUDOverlay(
+	TEXT("Blaster.HUD.CacheOverlay"),
+	GCacheHUDOverlay,
+	TEXT("1 caches the character overlay and announcement panels, 0 repaints them every frame. Compare stat Slate with both"),
+	FConsoleVariableDelegate::CreateLambda([](IConsoleVariable*)
+	{
+		//applies to widgets that are already up so the two can be compared in the same match
+		for(TObjectIterator<UCharacterOverlay> It; It; ++It){
+			It->UpdatePanelCaching();
+		}
+		for(TObjectIterator<UAnnouncement> It; It; ++It){
+			It->UpdatePanelCaching();
+		}
+	}));
+
+bool UCharacterOverlay::ShouldCachePanels()
+{
+	return GCacheHUDOverlay != 0;
+}
+
+void UCharacterOverlay::NativeConstruct()
+{
+	Super::NativeConstruct();
+
+	UpdatePanelCaching();
+}
+
+void UCharacterOverlay::UpdatePanelCaching()
+{
+	const bool bCache = ShouldCachePanels();
+	for(UInvalidationBox* Panel : {StaticPanel, StatsPanel, AmmoPanel, CountdownPanel}){
+		if(Panel){
+			Panel->SetCanCache(bCache);
+		}
+	}
+}
@@ -7,7 +7,10 @@
 #include "CharacterOverlay.generated.h"
 
 /**
- * 
+ * The overlay is split into invalidation panels so Slate can reuse what it painted last frame. StaticPanel holds the
+ * frames and labels that never change, StatsPanel health, score and defeats, AmmoPanel ammo and grenades, and
+ * CountdownPanel the match timer, so a change to one value only repaints its own panel. The panels are optional so an
+ * overlay blueprint without them still works, it just repaints everything
  */
 UCLASS()
 class BLASTER_API UCharacterOverlay : public UUserWidget
@@ -15,12 +18,35 @@ class BLASTER_API UCharacterOverlay : public UUserWidget
 	GENERATED_BODY()
 
 public:
+	//turns caching on the panels on or off to match Blaster.HUD.CacheOverlay
+	void UpdatePanelCaching();
+	static bool ShouldCachePanels();
+
+	UPROPERTY(meta = (BindWidgetOptional))
+	class UInvalidationBox* StaticPanel;
+
+	UPROPERTY(meta = (BindWidgetOptional))
+	UInvalidationBox* StatsPanel;
+
+	UPROPERTY(meta = (BindWidgetOptional))
+	UInvalidationBox* AmmoPanel;
+
+	UPROPERTY(meta = (BindWidgetOptional))
+	UInvalidationBox* CountdownPanel;
+
 	UPROPERTY(meta = (BindWidget))
 	class UProgressBar* HealthBar;
 
 	UPROPERTY(meta = (BindWidget))
 	class UTextBlock* HealthText;
 
+	//optional so overlays made before shield pickups existed still bind
+	UPROPERTY(meta = (BindWidgetOptional))
+	UProgressBar* ShieldBar;
+
+	UPROPERTY(meta = (BindWidgetOptional))
+	UTextBlock* ShieldText;
+
 	UPROPERTY(meta = (BindWidget))
 	UTextBlock* ScoreAmount;
 
@@ -38,4 +64,7 @@ public:
 
 	UPROPERTY(meta = (BindWidget))
 	UTextBlock* GrenadesText;
+
+protected:
+	virtual void NativeConstruct() override;
 };
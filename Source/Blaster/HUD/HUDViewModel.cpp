@@ -0,0 +1,80 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HUDViewModel.h"
+#include "Blaster/Blaster.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("HUD Widget Updates Per Second"), STAT_HUDWidgetUpdatesPerSecond, STATGROUP_Blaster);
+
+//ammo, grenades, score and defeats are almost always below this
+static constexpr int32 MaxCachedIntText = 256;
+
+FHUDViewModel::FHUDViewModel()
+{
+    FMemory::Memzero(Values);
+    FMemory::Memzero(PushedValues);
+    FMemory::Memzero(bHasValue);
+    FMemory::Memzero(bPushed);
+}
+
+void FHUDViewModel::Set(EHUDField Field, int32 Value)
+{
+    Values[(uint8)Field] = Value;
+    bHasValue[(uint8)Field] = true;
+}
+
+bool FHUDViewModel::NeedsPush(EHUDField Field) const
+{
+    const uint8 Index = (uint8)Field;
+    return bHasValue[Index] && (!bPushed[Index] || PushedValues[Index] != Values[Index]);
+}
+
+void FHUDViewModel::MarkPushed(EHUDField Field)
+{
+    const uint8 Index = (uint8)Field;
+    PushedValues[Index] = Values[Index];
+    bPushed[Index] = true;
+
+    PushesThisWindow++;
+}
+
+void FHUDViewModel::UpdateStats()
+{
+    //rolled over from here rather than from MarkPushed, so a second without any pushes reads 0
+    const double Now = FPlatformTime::Seconds();
+    if(Now - WindowStartTime >= 1.0){
+        SET_DWORD_STAT(STAT_HUDWidgetUpdatesPerSecond, PushesThisWindow);
+        PushesThisWindow = 0;
+        WindowStartTime = Now;
+    }
+}
+
+void FHUDViewModel::ResetPushed()
+{
+    FMemory::Memzero(bPushed);
+}
+
+FText FHUDViewModel::IntText(int32 Value)
+{
+    if(Value < 0 || Value >= MaxCachedIntText){
+        return FText::FromString(FString::FromInt(Value));
+    }
+
+    //built the first time each value is shown and reused after that. The HUD only runs on the game thread
+    static TArray<FText> CachedText;
+    if(CachedText.Num() == 0){
+        CachedText.SetNum(MaxCachedIntText);
+    }
+    if(CachedText[Value].IsEmpty()){
+        CachedText[Value] = FText::FromString(FString::FromInt(Value));
+    }
+    return CachedText[Value];
+}
+
+FText FHUDViewModel::CountdownText(int32 Seconds)
+{
+    if(Seconds < 0) {return FText();}
+
+    const int32 Minutes = Seconds / 60;
+    return FText::FromString(FString::Printf(TEXT("%02d:%02d"), Minutes, Seconds - Minutes * 60));
+}
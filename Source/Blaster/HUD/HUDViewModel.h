@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+//every value the character overlay and announcement show
+enum class EHUDField : uint8
+{
+	Health,
+	MaxHealth,
+	Shield,
+	MaxShield,
+	Score,
+	Defeats,
+	WeaponAmmo,
+	CarriedAmmo,
+	Grenades,
+	MatchCountdown,
+	AnnouncementCountdown,
+
+	MAX
+};
+
+/**
+ * Remembers the last value asked for and the last value actually pushed to a widget for every HUD field, so
+ * ABlasterPlayerController only touches a widget when what it shows would change. Values asked for before the overlay
+ * exists stay pending and get pushed once it's created
+ */
+class BLASTER_API FHUDViewModel
+{
+public:
+	FHUDViewModel();
+
+	void Set(EHUDField Field, int32 Value);
+	FORCEINLINE int32 Get(EHUDField Field) const { return Values[(uint8)Field]; }
+	FORCEINLINE bool HasValue(EHUDField Field) const { return bHasValue[(uint8)Field]; }
+
+	//true when Field has a value that the widget isn't showing yet
+	bool NeedsPush(EHUDField Field) const;
+	void MarkPushed(EHUDField Field);
+
+	//a new widget was created, so everything it shows has to be pushed again
+	void ResetPushed();
+
+	//writes the widget updates stat once a second. Called every frame by the controller whether anything was pushed or not
+	void UpdateStats();
+
+	//"%d" text for Value, shared between every field. Only the common small values are cached
+	static FText IntText(int32 Value);
+
+	//"mm:ss" text for a countdown in seconds
+	static FText CountdownText(int32 Seconds);
+
+private:
+
+	int32 Values[(uint8)EHUDField::MAX];
+	int32 PushedValues[(uint8)EHUDField::MAX];
+	bool bHasValue[(uint8)EHUDField::MAX];
+	bool bPushed[(uint8)EHUDField::MAX];
+
+	//pushes counted over the current one second window, for the widget updates stat
+	uint32 PushesThisWindow = 0;
+	double WindowStartTime = 0.0;
+};
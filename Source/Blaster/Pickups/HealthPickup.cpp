@@ -22,12 +22,17 @@ void AHealthPickup::OnSphereOverlap(UPrimitiveComponent *OverlappedComponent, AA
     if(BlasterCharacter){
         UBuffComponent* Buff = BlasterCharacter->GetBuff();
         if(Buff){
-            Buff->Heal(HealAmount, HealingTime);
+            ApplyBuff(Buff);
         }
     }
     Destroy();
 }
 
+void AHealthPickup::ApplyBuff(UBuffComponent* Buff)
+{
+    Buff->Heal(HealAmount, HealingTime);
+}
+
 
 void AHealthPickup::Destroyed()
 {
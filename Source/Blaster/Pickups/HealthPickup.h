@@ -7,7 +7,8 @@
 #include "HealthPickup.generated.h"
 
 /**
- * 
+ * Heals over time through the character's buff component. Other buff pickups derive from this one and only change
+ * which buff they hand out
  */
 UCLASS()
 class BLASTER_API AHealthPickup : public APickup
@@ -30,6 +31,9 @@ protected:
 		const FHitResult& SweepResult
 	);
 
+	//called on the server for the character that walked into the pickup
+	virtual void ApplyBuff(class UBuffComponent* Buff);
+
 private:
 
 	UPROPERTY(EditAnywhere)
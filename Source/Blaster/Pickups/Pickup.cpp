@@ -12,6 +12,8 @@ APickup::APickup()
 {
 	PrimaryActorTick.bCanEverTick = true;
 	bReplicates = true;
+	//nothing about a pickup changes while it waits to be picked up, so it only replicates once and then again when it's consumed
+	NetDormancy = DORM_DormantAll;
 
 	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
 
@@ -0,0 +1,10 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShieldPickup.h"
+#include "Blaster/BlasterComponents/BuffComponent.h"
+
+void AShieldPickup::ApplyBuff(UBuffComponent* Buff)
+{
+    Buff->ReplenishShield(ShieldReplenishAmount, ShieldReplenishTime);
+}
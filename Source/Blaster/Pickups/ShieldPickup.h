@@ -0,0 +1,29 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HealthPickup.h"
+#include "ShieldPickup.generated.h"
+
+/**
+ * 
+ */
+UCLASS()
+class BLASTER_API AShieldPickup : public AHealthPickup
+{
+	GENERATED_BODY()
+
+protected:
+
+	virtual void ApplyBuff(class UBuffComponent* Buff) override;
+
+private:
+
+	UPROPERTY(EditAnywhere)
+	float ShieldReplenishAmount = 100.f;
+
+	UPROPERTY(EditAnywhere)
+	float ShieldReplenishTime = 5.f;
+
+};
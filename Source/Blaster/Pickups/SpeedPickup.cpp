@@ -0,0 +1,10 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SpeedPickup.h"
+#include "Blaster/BlasterComponents/BuffComponent.h"
+
+void ASpeedPickup::ApplyBuff(UBuffComponent* Buff)
+{
+    Buff->BuffSpeed(SpeedMultiplier, SpeedBuffTime);
+}
@@ -0,0 +1,30 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HealthPickup.h"
+#include "SpeedPickup.generated.h"
+
+/**
+ * 
+ */
+UCLASS()
+class BLASTER_API ASpeedPickup : public AHealthPickup
+{
+	GENERATED_BODY()
+
+protected:
+
+	virtual void ApplyBuff(class UBuffComponent* Buff) override;
+
+private:
+
+	//scales walking, crouching and aiming speed alike
+	UPROPERTY(EditAnywhere)
+	float SpeedMultiplier = 1.5f;
+
+	UPROPERTY(EditAnywhere)
+	float SpeedBuffTime = 30.f;
+
+};
@@ -13,6 +13,7 @@
 #include "Blaster/HUD/Announcement.h"
 #include "Kismet/GameplayStatics.h"
 #include "Blaster/BlasterComponents/CombatComponent.h"
+#include "Blaster/BlasterComponents/BuffComponent.h"
 #include "Blaster/GameState/BlasterGameState.h"
 
 void ABlasterPlayerController::BeginPlay()
@@ -51,27 +52,6 @@ void ABlasterPlayerController::SetHUDTime()
     CountdownInt = SecondsLeft;
 }
 
-void ABlasterPlayerController::PollInit()
-{
-    //this is needing to be done because the overlay does not yet exist when we transition into the map
-    if(CharacterOverlay == nullptr){
-        if(BlasterHUD && BlasterHUD->CharacterOverlay){
-            CharacterOverlay = BlasterHUD->CharacterOverlay;
-            if(CharacterOverlay){
-                SetHUDHealth(HUDCurrentHealth, HUDMaxHealth);
-                SetHUDScore(HUDScore);
-                SetHUDDefeats(HUDDefeats);
-                
-                ABlasterCharacter* BlasterCharacter = Cast<ABlasterCharacter>(GetPawn());
-				if (BlasterCharacter && BlasterCharacter->GetCombat())
-				{
-					SetHUDGrenades(BlasterCharacter->GetCombat()->GetGrenades());
-				}
-            }
-        }
-    }
-}
-
 void ABlasterPlayerController::ServerRequestServerTime_Implementation(float TimeOfClientRequest)
 {
     //this function is called from the client that is connecting
@@ -87,6 +67,7 @@ void ABlasterPlayerController::ClientReportServerTime_Implementation(float TimeO
     //this function is being called by the server because this client has requested to know what the time on the server is
 
     float RoundTripTime = GetWorld()->GetTimeSeconds() - TimeOfClientRequest;
+    SingleTripTime = 0.5f * RoundTripTime;
     float CurrentServerTime = TimeServerReceivedClientRequest + (0.5f * RoundTripTime);
     ClientServerDelta = CurrentServerTime - GetWorld()->GetTimeSeconds();
 }
@@ -140,141 +121,162 @@ void ABlasterPlayerController::OnRep_MatchState()
 
 void ABlasterPlayerController::SetHUDHealth(float CurrentHealth, float MaxHealth)
 {
-    //making sure that we are trying to get the blaster hud before using it
-    BlasterHUD = BlasterHUD == nullptr ? Cast<ABlasterHUD>(GetHUD()) : BlasterHUD;
-
-    //checking if the hud, overlay, and all it's components are valid
-    bool bHUDValid = BlasterHUD && BlasterHUD->CharacterOverlay && BlasterHUD->CharacterOverlay->HealthBar && BlasterHUD->CharacterOverlay->HealthText;
+    //the text only shows whole numbers, so the bar only moves when one of them changes
+    HUDViewModel.Set(EHUDField::Health, FMath::CeilToInt(CurrentHealth));
+    HUDViewModel.Set(EHUDField::MaxHealth, FMath::CeilToInt(MaxHealth));
+    PushHUDHealth();
+}
 
-    if(bHUDValid){
-        const float HealthPercent = CurrentHealth / MaxHealth;
-        BlasterHUD->CharacterOverlay->HealthBar->SetPercent(HealthPercent);
-        FString HealthText = FString::Printf(TEXT("%d/%d"), FMath::CeilToInt(CurrentHealth), FMath::CeilToInt(MaxHealth));
-        BlasterHUD->CharacterOverlay->HealthText->SetText(FText::FromString(HealthText));
-    }
-    else{
-        bInitializeCharacterOverlay = true;
-        HUDCurrentHealth = CurrentHealth;
-        HUDMaxHealth = MaxHealth;
-    }
+void ABlasterPlayerController::SetHUDShield(float Shield, float MaxShield)
+{
+    HUDViewModel.Set(EHUDField::Shield, FMath::CeilToInt(Shield));
+    HUDViewModel.Set(EHUDField::MaxShield, FMath::CeilToInt(MaxShield));
+    PushHUDShield();
 }
 
 void ABlasterPlayerController::SetHUDScore(float Score)
 {
-    //making sure that we are trying to get the blaster hud before using it
-    BlasterHUD = BlasterHUD == nullptr ? Cast<ABlasterHUD>(GetHUD()) : BlasterHUD;
-
-    //checking if the hud, overlay, and all it's components are valid
-    bool bHUDValid = BlasterHUD && BlasterHUD->CharacterOverlay && BlasterHUD->CharacterOverlay->ScoreAmount;
-    if(bHUDValid){
-        FString ScoreText = FString::Printf(TEXT("%d"), FMath::FloorToInt(Score));
-        BlasterHUD->CharacterOverlay->ScoreAmount->SetText(FText::FromString(ScoreText));
-    }
-    else{
-        bInitializeCharacterOverlay = true;
-        HUDScore = Score;
-    }
+    HUDViewModel.Set(EHUDField::Score, FMath::FloorToInt(Score));
+    PushHUDText(EHUDField::Score);
 }
 
 void ABlasterPlayerController::SetHUDDefeats(int32 Defeats)
 {
-    BlasterHUD = BlasterHUD == nullptr ? Cast<ABlasterHUD>(GetHUD()) : BlasterHUD;
-
-    bool bHUDValid = BlasterHUD && BlasterHUD->CharacterOverlay && BlasterHUD->CharacterOverlay->DefeatsAmount;
-    if(bHUDValid){
-        FString DefeatsText = FString::Printf(TEXT("%d"), Defeats);
-        BlasterHUD->CharacterOverlay->DefeatsAmount->SetText(FText::FromString(DefeatsText));
-    }
-    else{
-        bInitializeCharacterOverlay = true;
-        HUDDefeats = Defeats;
-    }
+    HUDViewModel.Set(EHUDField::Defeats, Defeats);
+    PushHUDText(EHUDField::Defeats);
 }
 
 void ABlasterPlayerController::SetHUDWeaponAmmo(int32 Ammo)
 {
-    BlasterHUD = BlasterHUD == nullptr ? Cast<ABlasterHUD>(GetHUD()) : BlasterHUD;
-	bool bHUDValid = BlasterHUD &&
-		BlasterHUD->CharacterOverlay &&
-		BlasterHUD->CharacterOverlay->WeaponAmmoAmount;
-	if (bHUDValid)
-	{
-		FString AmmoText = FString::Printf(TEXT("%d"), Ammo);
-		BlasterHUD->CharacterOverlay->WeaponAmmoAmount->SetText(FText::FromString(AmmoText));
-	}
+    HUDViewModel.Set(EHUDField::WeaponAmmo, Ammo);
+    PushHUDText(EHUDField::WeaponAmmo);
 }
 
 void ABlasterPlayerController::SetHUDCarriedAmmo(int32 Ammo)
 {
-    BlasterHUD = BlasterHUD == nullptr ? Cast<ABlasterHUD>(GetHUD()) : BlasterHUD;
-	bool bHUDValid = BlasterHUD &&
-		BlasterHUD->CharacterOverlay &&
-		BlasterHUD->CharacterOverlay->CarriedAmmoAmount;
-	if (bHUDValid)
-	{
-		FString AmmoText = FString::Printf(TEXT("%d"), Ammo);
-		BlasterHUD->CharacterOverlay->CarriedAmmoAmount->SetText(FText::FromString(AmmoText));
-	}
+    HUDViewModel.Set(EHUDField::CarriedAmmo, Ammo);
+    PushHUDText(EHUDField::CarriedAmmo);
 }
 
 void ABlasterPlayerController::SetHUDMatchCountdown(float CountdownTime)
 {
+    //a negative countdown clears the text
+    HUDViewModel.Set(EHUDField::MatchCountdown, CountdownTime < 0.f ? -1 : FMath::FloorToInt(CountdownTime));
+    PushHUDText(EHUDField::MatchCountdown);
+}
+
+void ABlasterPlayerController::SetHUDAnnouncementCountdown(float CountdownTime)
+{
+    HUDViewModel.Set(EHUDField::AnnouncementCountdown, CountdownTime < 0.f ? -1 : FMath::FloorToInt(CountdownTime));
+    PushHUDText(EHUDField::AnnouncementCountdown);
+}
+
+void ABlasterPlayerController::SetHUDGrenades(int32 Grenades)
+{
+    HUDViewModel.Set(EHUDField::Grenades, Grenades);
+    PushHUDText(EHUDField::Grenades);
+}
+
+/**
+ * Pushing to the widgets
+ */
+
+UTextBlock* ABlasterPlayerController::GetHUDTextBlock(EHUDField Field)
+{
+    //making sure that we are trying to get the blaster hud before using it
     BlasterHUD = BlasterHUD == nullptr ? Cast<ABlasterHUD>(GetHUD()) : BlasterHUD;
-	bool bHUDValid = BlasterHUD &&
-		BlasterHUD->CharacterOverlay &&
-		BlasterHUD->CharacterOverlay->MatchCountdownText;
-	if (bHUDValid)
-	{
+    if(BlasterHUD == nullptr) {return nullptr;}
 
-        if(CountdownTime < 0.f){
-            BlasterHUD->CharacterOverlay->MatchCountdownText->SetText(FText());
-            return;
-        }
+    if(Field == EHUDField::AnnouncementCountdown){
+        return BlasterHUD->Announcement ? BlasterHUD->Announcement->WarmupTime : nullptr;
+    }
 
-        int32 Minutes = FMath::FloorToInt(CountdownTime / 60.f);
-        int32 Seconds = CountdownTime - Minutes * 60;
+    UCharacterOverlay* Overlay = BlasterHUD->CharacterOverlay;
+    if(Overlay == nullptr) {return nullptr;}
+    switch(Field){
+        case EHUDField::Score: return Overlay->ScoreAmount;
+        case EHUDField::Defeats: return Overlay->DefeatsAmount;
+        case EHUDField::WeaponAmmo: return Overlay->WeaponAmmoAmount;
+        case EHUDField::CarriedAmmo: return Overlay->CarriedAmmoAmount;
+        case EHUDField::Grenades: return Overlay->GrenadesText;
+        case EHUDField::MatchCountdown: return Overlay->MatchCountdownText;
+        default: return nullptr;
+    }
+}
 
-		FString CountdownText = FString::Printf(TEXT("%02d:%02d"), Minutes, Seconds);
-		BlasterHUD->CharacterOverlay->MatchCountdownText->SetText(FText::FromString(CountdownText));
-	}
+void ABlasterPlayerController::PushHUDText(EHUDField Field)
+{
+    if(!HUDViewModel.NeedsPush(Field)) {return;}
+
+    //no widget yet, the value stays pending in the view model until the overlay is created
+    UTextBlock* TextBlock = GetHUDTextBlock(Field);
+    if(TextBlock == nullptr) {return;}
+
+    const int32 Value = HUDViewModel.Get(Field);
+    const bool bCountdown = Field == EHUDField::MatchCountdown || Field == EHUDField::AnnouncementCountdown;
+    TextBlock->SetText(bCountdown ? FHUDViewModel::CountdownText(Value) : FHUDViewModel::IntText(Value));
+    HUDViewModel.MarkPushed(Field);
 }
 
-void ABlasterPlayerController::SetHUDAnnouncementCountdown(float CountdownTime)
+void ABlasterPlayerController::PushHUDHealth()
 {
+    if(!HUDViewModel.NeedsPush(EHUDField::Health) && !HUDViewModel.NeedsPush(EHUDField::MaxHealth)) {return;}
+
     BlasterHUD = BlasterHUD == nullptr ? Cast<ABlasterHUD>(GetHUD()) : BlasterHUD;
-    bool bHUDValid = BlasterHUD &&
-		BlasterHUD->Announcement &&
-		BlasterHUD->Announcement->WarmupTime;
-	if (bHUDValid)
-	{
-        if(CountdownTime < 0.f){
-            BlasterHUD->Announcement->WarmupTime->SetText(FText());
-            return;
-        }
+    //checking if the hud, overlay, and all it's components are valid
+    bool bHUDValid = BlasterHUD && BlasterHUD->CharacterOverlay && BlasterHUD->CharacterOverlay->HealthBar && BlasterHUD->CharacterOverlay->HealthText;
+    if(!bHUDValid) {return;}
+
+    const int32 CurrentHealth = HUDViewModel.Get(EHUDField::Health);
+    const int32 MaxHealth = HUDViewModel.Get(EHUDField::MaxHealth);
+    const float HealthPercent = MaxHealth > 0 ? (float)CurrentHealth / MaxHealth : 0.f;
+    BlasterHUD->CharacterOverlay->HealthBar->SetPercent(HealthPercent);
+    FString HealthText = FString::Printf(TEXT("%d/%d"), CurrentHealth, MaxHealth);
+    BlasterHUD->CharacterOverlay->HealthText->SetText(FText::FromString(HealthText));
+    HUDViewModel.MarkPushed(EHUDField::Health);
+    HUDViewModel.MarkPushed(EHUDField::MaxHealth);
+}
+
+void ABlasterPlayerController::PushHUDShield()
+{
+    if(!HUDViewModel.NeedsPush(EHUDField::Shield) && !HUDViewModel.NeedsPush(EHUDField::MaxShield)) {return;}
 
-        int32 Minutes = FMath::FloorToInt(CountdownTime / 60.f);
-        int32 Seconds = CountdownTime - Minutes * 60;
+    BlasterHUD = BlasterHUD == nullptr ? Cast<ABlasterHUD>(GetHUD()) : BlasterHUD;
+    UCharacterOverlay* Overlay = BlasterHUD ? BlasterHUD->CharacterOverlay : nullptr;
+    if(Overlay == nullptr) {return;}
 
-		FString CountdownText = FString::Printf(TEXT("%02d:%02d"), Minutes, Seconds);
-		BlasterHUD->Announcement->WarmupTime->SetText(FText::FromString(CountdownText));
-	}
+    const int32 Shield = HUDViewModel.Get(EHUDField::Shield);
+    const int32 MaxShield = HUDViewModel.Get(EHUDField::MaxShield);
+    if(Overlay->ShieldBar){
+        Overlay->ShieldBar->SetPercent(MaxShield > 0 ? (float)Shield / MaxShield : 0.f);
+    }
+    if(Overlay->ShieldText){
+        Overlay->ShieldText->SetText(FText::FromString(FString::Printf(TEXT("%d/%d"), Shield, MaxShield)));
+    }
+    HUDViewModel.MarkPushed(EHUDField::Shield);
+    HUDViewModel.MarkPushed(EHUDField::MaxShield);
 }
 
-void ABlasterPlayerController::SetHUDGrenades(int32 Grenades)
+void ABlasterPlayerController::OnCharacterOverlayCreated(UCharacterOverlay* Overlay)
 {
-	BlasterHUD = BlasterHUD == nullptr ? Cast<ABlasterHUD>(GetHUD()) : BlasterHUD;
-	bool bHUDValid = BlasterHUD &&
-		BlasterHUD->CharacterOverlay &&
-		BlasterHUD->CharacterOverlay->GrenadesText;
-	if (bHUDValid)
-	{
-		FString GrenadesText = FString::Printf(TEXT("%d"), Grenades);
-		BlasterHUD->CharacterOverlay->GrenadesText->SetText(FText::FromString(GrenadesText));
-	}
-	else
-	{
-		HUDGrenades = Grenades;
-	}
+    //this is needing to be done because the overlay does not yet exist when we transition into the map.
+    //everything that was set before it existed is still in the view model
+    HUDViewModel.ResetPushed();
+
+    ABlasterCharacter* BlasterCharacter = Cast<ABlasterCharacter>(GetPawn());
+    if (BlasterCharacter && BlasterCharacter->GetCombat())
+    {
+        HUDViewModel.Set(EHUDField::Grenades, BlasterCharacter->GetCombat()->GetGrenades());
+    }
+
+    PushHUDHealth();
+    PushHUDShield();
+    for(uint8 Field = 0; Field < (uint8)EHUDField::MAX; ++Field){
+        if(Field != (uint8)EHUDField::Health && Field != (uint8)EHUDField::MaxHealth &&
+            Field != (uint8)EHUDField::Shield && Field != (uint8)EHUDField::MaxShield){
+            PushHUDText((EHUDField)Field);
+        }
+    }
 }
 
 void ABlasterPlayerController::OnPossess(APawn *InPawn)
@@ -284,6 +286,9 @@ void ABlasterPlayerController::OnPossess(APawn *InPawn)
     ABlasterCharacter* BlasterCharacter = Cast<ABlasterCharacter>(InPawn);
     if(BlasterCharacter){
         SetHUDHealth(BlasterCharacter->GetHealth(), BlasterCharacter->GetMaxHealth());
+        if(BlasterCharacter->GetBuff()){
+            SetHUDShield(BlasterCharacter->GetBuff()->GetShield(), BlasterCharacter->GetBuff()->GetMaxShield());
+        }
     }
 }
 
@@ -320,6 +325,9 @@ void ABlasterPlayerController::HandleMatchHasStarted()
     BlasterHUD = BlasterHUD == nullptr ? Cast<ABlasterHUD>(GetHUD()) : BlasterHUD;
 	if (BlasterHUD)
 	{
+        if(!BlasterHUD->OnCharacterOverlayCreated.IsBoundToObject(this)){
+            BlasterHUD->OnCharacterOverlayCreated.AddUObject(this, &ThisClass::OnCharacterOverlayCreated);
+        }
         if(BlasterHUD->CharacterOverlay == nullptr) {BlasterHUD->AddCharacterOverlay();}
         if(BlasterHUD->Announcement){
             BlasterHUD->Announcement->SetVisibility(ESlateVisibility::Hidden);
@@ -342,7 +350,8 @@ void ABlasterPlayerController::HandleCooldown()
             ABlasterGameState* BlasterGameState = Cast<ABlasterGameState>(UGameplayStatics::GetGameState(this));
             ABlasterPlayerState* BlasterPlayerState = GetPlayerState<ABlasterPlayerState>();
             if(BlasterGameState && BlasterPlayerState){
-                TArray<ABlasterPlayerState*> TopPlayers = BlasterGameState->TopScoringPlayers;
+                TArray<ABlasterPlayerState*> TopPlayers;
+                BlasterGameState->GetTopScoringPlayers(TopPlayers);
                 FString InfoTextString;
                 if(TopPlayers.Num() == 0){
                     InfoTextString = FString("There is no winner.");
@@ -366,7 +375,7 @@ void ABlasterPlayerController::HandleCooldown()
 
     ABlasterCharacter* BlasterCharacter = Cast<ABlasterCharacter>(GetPawn());
     if(BlasterCharacter && BlasterCharacter->GetCombat()){
-        BlasterCharacter->bDisableGameplay = true;
+        BlasterCharacter->SetDisableGameplay(true);
         BlasterCharacter->GetCombat()->FireButtonPressed(false);
     }
 }
@@ -377,7 +386,9 @@ void ABlasterPlayerController::Tick(float DeltaTime)
 
     SetHUDTime();
     CheckTimeSync(DeltaTime);
-    PollInit();
+    if(IsLocalController()){
+        HUDViewModel.UpdateStats();
+    }
 }
 
 void ABlasterPlayerController::GetLifetimeReplicatedProps(TArray<FLifetimeProperty> &OutLifetimeProps) const
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/PlayerController.h"
+#include "Blaster/HUD/HUDViewModel.h"
 #include "BlasterPlayerController.generated.h"
 
 /**
@@ -17,6 +18,7 @@ class BLASTER_API ABlasterPlayerController : public APlayerController
 public:
 
 	void SetHUDHealth(float CurrentHealth, float MaxHealth);
+	void SetHUDShield(float Shield, float MaxShield);
 	void SetHUDScore(float Score);
 	void SetHUDDefeats(int32 Defeats);
 	void SetHUDWeaponAmmo(int32 Ammo);
@@ -35,14 +37,14 @@ public:
 	void HandleMatchHasStarted();
 	void HandleCooldown();
 
+	float SingleTripTime = 0.f; //half of the round trip time measured by the last time sync, used for server-side rewind
+
 protected:
 
 	virtual void BeginPlay() override;
 
 	void SetHUDTime();
 
-	void PollInit();
-
 	/**
 	 * Sync time between client and server
 	 */
@@ -90,15 +92,20 @@ private:
 	UFUNCTION()
 	void OnRep_MatchState();
 
-	UPROPERTY()
-	class UCharacterOverlay* CharacterOverlay;
-	bool bInitializeCharacterOverlay = false;
+	/**
+	 * HUD
+	 * The SetHUD* functions only record the value in the view model, and the Push functions only touch a widget when
+	 * the value it shows is out of date
+	 */
+
+	FHUDViewModel HUDViewModel;
 
-	float HUDCurrentHealth;
-	float HUDMaxHealth;
-	float HUDScore;
-	int32 HUDDefeats;
+	class UTextBlock* GetHUDTextBlock(EHUDField Field);
+	void PushHUDText(EHUDField Field);
+	void PushHUDHealth();
+	void PushHUDShield();
 
-	int32 HUDGrenades;
+	//bound to ABlasterHUD::OnCharacterOverlayCreated, pushes everything that was set before the overlay existed
+	void OnCharacterOverlayCreated(class UCharacterOverlay* Overlay);
 
 };
@@ -4,6 +4,7 @@
 #include "BlasterPlayerState.h"
 #include "Blaster/Character/BlasterCharacter.h"
 #include "Blaster/PlayerController/BlasterPlayerController.h"
+#include "Blaster/GameState/BlasterGameState.h"
 #include "Net/UnrealNetwork.h"
 
 
@@ -30,6 +31,10 @@ void ABlasterPlayerState::OnRep_Score()
 void ABlasterPlayerState::AddToScore(float ScoreAmount)
 {
     SetScore(GetScore() + ScoreAmount);
+    if(ScoreAmount > 0.f){
+        ++KillStreak;
+    }
+    UpdateLeaderboard();
 
     Character = Character == nullptr ? Cast<ABlasterCharacter>(GetPawn()) : Character;
     if(Character){
@@ -43,6 +48,10 @@ void ABlasterPlayerState::AddToScore(float ScoreAmount)
 void ABlasterPlayerState::AddToDefeats(int32 DefeatsAmount)
 {
     Defeats += DefeatsAmount;
+    if(DefeatsAmount > 0){
+        KillStreak = 0;
+    }
+    UpdateLeaderboard();
     Character = Character == nullptr ? Cast<ABlasterCharacter>(GetPawn()) : Character;
     if(Character){
         Controller = Controller == nullptr ? Cast<ABlasterPlayerController>(Character->Controller) : Controller;
@@ -52,6 +61,17 @@ void ABlasterPlayerState::AddToDefeats(int32 DefeatsAmount)
     }
 }
 
+void ABlasterPlayerState::UpdateLeaderboard()
+{
+    //the character also calls the Add functions on clients with zero to fill in the HUD
+    if(!HasAuthority()) {return;}
+
+    ABlasterGameState* BlasterGameState = GetWorld() ? GetWorld()->GetGameState<ABlasterGameState>() : nullptr;
+    if(BlasterGameState){
+        BlasterGameState->UpdateLeaderboard(this);
+    }
+}
+
 void ABlasterPlayerState::OnRep_Defeats()
 {
     Character = Character == nullptr ? Cast<ABlasterCharacter>(GetPawn()) : Character;
@@ -31,6 +31,9 @@ public:
 	void AddToScore(float ScoreAmount);
 	void AddToDefeats(int32 DefeatsAmount);
 
+	FORCEINLINE int32 GetDefeats() const { return Defeats; }
+	FORCEINLINE int32 GetKillStreak() const { return KillStreak; }
+
 
 private:
 	UPROPERTY()
@@ -41,4 +44,9 @@ private:
 	UPROPERTY(ReplicatedUsing = OnRep_Defeats)
 	int32 Defeats;
 
+	//only kept on the server, clients read it from the leaderboard
+	int32 KillStreak = 0;
+
+	void UpdateLeaderboard();
+
 };
@@ -0,0 +1,220 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "BlasterReplicationGraph.h"
+#include "Blaster/Character/BlasterCharacter.h"
+#include "Blaster/Weapon/Weapon.h"
+#include "Blaster/Weapon/Projectile.h"
+#include "Blaster/Pickups/Pickup.h"
+#include "Engine/NetDriver.h"
+#include "Engine/LevelScriptActor.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerState.h"
+#include "GameFramework/PlayerController.h"
+#include "UObject/UObjectIterator.h"
+
+void UBlasterReplicationGraph::InitGlobalActorClassSettings()
+{
+	Super::InitGlobalActorClassSettings();
+
+	//classes we route on purpose. Anything else gets a policy from its defaults the first time it is seen
+	ClassRepNodePolicies.Set(AReplicationGraphDebugActor::StaticClass(), EClassRepNodeMapping::NotRouted);
+	ClassRepNodePolicies.Set(ALevelScriptActor::StaticClass(), EClassRepNodeMapping::NotRouted);
+	//player controllers only go to their own connection, which the per connection node takes care of
+	ClassRepNodePolicies.Set(APlayerController::StaticClass(), EClassRepNodeMapping::NotRouted);
+	ClassRepNodePolicies.Set(AGameStateBase::StaticClass(), EClassRepNodeMapping::RelevantAllConnections);
+	ClassRepNodePolicies.Set(APlayerState::StaticClass(), EClassRepNodeMapping::RelevantAllConnections);
+	ClassRepNodePolicies.Set(ABlasterCharacter::StaticClass(), EClassRepNodeMapping::Spatialize_Dynamic);
+	//pooled projectiles go dormant while they are parked, which moves them out of the grid's per frame dynamic list
+	ClassRepNodePolicies.Set(AProjectile::StaticClass(), EClassRepNodeMapping::Spatialize_Dormancy);
+	//weapons are routed by hand, in the grid while on the ground and as a dependent of their character while equipped.
+	//On the ground they sit in the grid's dormancy lists, so a weapon that has settled costs as much as a static actor
+	ClassRepNodePolicies.Set(AWeapon::StaticClass(), EClassRepNodeMapping::NotRouted);
+	ClassRepNodePolicies.Set(APickup::StaticClass(), EClassRepNodeMapping::Spatialize_Static);
+
+	//every replicated class gets its update rate and cull distance from its defaults, the same values the default driver uses
+	for(TObjectIterator<UClass> It; It; ++It){
+		UClass* Class = *It;
+		AActor* ActorCDO = Cast<AActor>(Class->GetDefaultObject(false));
+		if(ActorCDO == nullptr || !ActorCDO->GetIsReplicated()) {continue;}
+		//skip blueprint compile leftovers
+		if(Class->GetName().StartsWith(TEXT("SKEL_")) || Class->GetName().StartsWith(TEXT("REINST_"))) {continue;}
+
+		FClassReplicationInfo ClassInfo;
+		ClassInfo.ReplicationPeriodFrame = GetReplicationPeriodFrameForFrequency(ActorCDO->NetUpdateFrequency);
+		const EClassRepNodeMapping Policy = GetMappingPolicy(Class);
+		//weapons are NotRouted only because they are put in the grid by hand, they still need a cull distance there
+		const bool bRoutedByHand = Class->IsChildOf(AWeapon::StaticClass());
+		if(bRoutedByHand || (Policy != EClassRepNodeMapping::RelevantAllConnections && Policy != EClassRepNodeMapping::NotRouted)){
+			ClassInfo.SetCullDistanceSquared(ActorCDO->NetCullDistanceSquared);
+		}
+		GlobalActorReplicationInfoMap.SetClassInfo(Class, ClassInfo);
+	}
+}
+
+EClassRepNodeMapping UBlasterReplicationGraph::GetMappingPolicy(const UClass* Class)
+{
+	if(const EClassRepNodeMapping* Policy = ClassRepNodePolicies.Get(Class)){
+		return *Policy;
+	}
+
+	const AActor* ActorCDO = Cast<AActor>(Class->GetDefaultObject());
+	EClassRepNodeMapping Policy = EClassRepNodeMapping::NotRouted;
+	if(ActorCDO == nullptr || ActorCDO->bOnlyRelevantToOwner){
+		Policy = EClassRepNodeMapping::NotRouted;
+	}
+	else if(ActorCDO->bAlwaysRelevant){
+		Policy = EClassRepNodeMapping::RelevantAllConnections;
+	}
+	else if(ActorCDO->IsReplicatingMovement()){
+		Policy = EClassRepNodeMapping::Spatialize_Dynamic;
+	}
+	else{
+		Policy = EClassRepNodeMapping::Spatialize_Static;
+	}
+	ClassRepNodePolicies.Set(Class, Policy);
+	return Policy;
+}
+
+void UBlasterReplicationGraph::InitGlobalGraphNodes()
+{
+	GridNode = CreateNewNode<UReplicationGraphNode_GridSpatialization2D>();
+	GridNode->CellSize = GridCellSize;
+	GridNode->SpatialBias = GridSpatialBias;
+	AddGlobalGraphNode(GridNode);
+
+	AlwaysRelevantNode = CreateNewNode<UReplicationGraphNode_ActorList>();
+	AddGlobalGraphNode(AlwaysRelevantNode);
+}
+
+void UBlasterReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection)
+{
+	Super::InitConnectionGraphNodes(RepGraphConnection);
+
+	//the connection's own player controller, pawn and view target
+	UReplicationGraphNode_AlwaysRelevant_ForConnection* AlwaysRelevantForConnectionNode = CreateNewNode<UReplicationGraphNode_AlwaysRelevant_ForConnection>();
+	AddConnectionGraphNode(AlwaysRelevantForConnectionNode, RepGraphConnection);
+}
+
+void UBlasterReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo)
+{
+	//a weapon that is already in someone's hands when it starts replicating goes straight to its character
+	if(AWeapon* Weapon = Cast<AWeapon>(ActorInfo.Actor)){
+		if(ABlasterCharacter* Character = Cast<ABlasterCharacter>(Weapon->GetOwner())){
+			GlobalActorReplicationInfoMap.AddDependentActor(Character, Weapon);
+		}
+		else{
+			bool bAlreadyInGrid = false;
+			WeaponsInGrid.Add(Weapon, &bAlreadyInGrid);
+			if(!bAlreadyInGrid){
+				AddToGrid(ActorInfo, GlobalInfo, EClassRepNodeMapping::Spatialize_Dormancy);
+			}
+		}
+		return;
+	}
+
+	const EClassRepNodeMapping Policy = GetMappingPolicy(ActorInfo.Class);
+	if(Policy == EClassRepNodeMapping::RelevantAllConnections){
+		AlwaysRelevantNode->NotifyAddNetworkActor(ActorInfo);
+	}
+	else{
+		AddToGrid(ActorInfo, GlobalInfo, Policy);
+	}
+}
+
+void UBlasterReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo)
+{
+	if(AWeapon* Weapon = Cast<AWeapon>(ActorInfo.Actor)){
+		if(WeaponsInGrid.Remove(Weapon) > 0){
+			RemoveFromGrid(ActorInfo, EClassRepNodeMapping::Spatialize_Dormancy);
+		}
+		else if(ABlasterCharacter* Character = Cast<ABlasterCharacter>(Weapon->GetOwner())){
+			GlobalActorReplicationInfoMap.RemoveDependentActor(Character, Weapon);
+		}
+		return;
+	}
+
+	const EClassRepNodeMapping Policy = GetMappingPolicy(ActorInfo.Class);
+	if(Policy == EClassRepNodeMapping::RelevantAllConnections){
+		AlwaysRelevantNode->NotifyRemoveNetworkActor(ActorInfo);
+	}
+	else{
+		RemoveFromGrid(ActorInfo, Policy);
+	}
+}
+
+void UBlasterReplicationGraph::AddToGrid(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo, EClassRepNodeMapping Policy)
+{
+	switch(Policy){
+		case EClassRepNodeMapping::Spatialize_Static:
+			GridNode->AddActor_Static(ActorInfo, GlobalInfo);
+			break;
+		case EClassRepNodeMapping::Spatialize_Dynamic:
+			GridNode->AddActor_Dynamic(ActorInfo, GlobalInfo);
+			break;
+		case EClassRepNodeMapping::Spatialize_Dormancy:
+			GridNode->AddActor_Dormancy(ActorInfo, GlobalInfo);
+			break;
+		default:
+			break;
+	}
+}
+
+void UBlasterReplicationGraph::RemoveFromGrid(const FNewReplicatedActorInfo& ActorInfo, EClassRepNodeMapping Policy)
+{
+	switch(Policy){
+		case EClassRepNodeMapping::Spatialize_Static:
+			GridNode->RemoveActor_Static(ActorInfo);
+			break;
+		case EClassRepNodeMapping::Spatialize_Dynamic:
+			GridNode->RemoveActor_Dynamic(ActorInfo);
+			break;
+		case EClassRepNodeMapping::Spatialize_Dormancy:
+			GridNode->RemoveActor_Dormancy(ActorInfo);
+			break;
+		default:
+			break;
+	}
+}
+
+UBlasterReplicationGraph* UBlasterReplicationGraph::Get(const UWorld* World)
+{
+	UNetDriver* NetDriver = World ? World->GetNetDriver() : nullptr;
+	return NetDriver ? Cast<UBlasterReplicationGraph>(NetDriver->GetReplicationDriver()) : nullptr;
+}
+
+void UBlasterReplicationGraph::NotifyWeaponEquipped(ABlasterCharacter* Character, AWeapon* Weapon)
+{
+	UBlasterReplicationGraph* Graph = Get(Weapon ? Weapon->GetWorld() : nullptr);
+	if(Graph == nullptr || Character == nullptr) {return;}
+
+	//a weapon handed straight to a character when it spawned never went into the grid
+	if(Graph->WeaponsInGrid.Remove(Weapon) > 0){
+		Graph->GridNode->RemoveActor_Dormancy(FNewReplicatedActorInfo(Weapon));
+	}
+	Graph->GlobalActorReplicationInfoMap.AddDependentActor(Character, Weapon);
+}
+
+void UBlasterReplicationGraph::NotifyWeaponDropped(ABlasterCharacter* Character, AWeapon* Weapon)
+{
+	//a weapon without a character was never taken out of the grid
+	UBlasterReplicationGraph* Graph = Get(Weapon ? Weapon->GetWorld() : nullptr);
+	if(Graph == nullptr || Character == nullptr) {return;}
+
+	Graph->GlobalActorReplicationInfoMap.RemoveDependentActor(Character, Weapon);
+	bool bAlreadyInGrid = false;
+	Graph->WeaponsInGrid.Add(Weapon, &bAlreadyInGrid);
+	if(!bAlreadyInGrid){
+		Graph->GridNode->AddActor_Dormancy(FNewReplicatedActorInfo(Weapon), Graph->GlobalActorReplicationInfoMap.Get(Weapon));
+	}
+}
+
+void UBlasterReplicationGraph::NotifyNetUpdateFrequencyChanged(AActor* Actor)
+{
+	UBlasterReplicationGraph* Graph = Get(Actor ? Actor->GetWorld() : nullptr);
+	if(Graph == nullptr) {return;}
+
+	if(FGlobalActorReplicationInfo* GlobalInfo = Graph->GlobalActorReplicationInfoMap.Find(Actor)){
+		GlobalInfo->Settings.ReplicationPeriodFrame = Graph->GetReplicationPeriodFrameForFrequency(Actor->NetUpdateFrequency);
+	}
+}
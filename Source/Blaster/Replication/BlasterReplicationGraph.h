@@ -0,0 +1,73 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ReplicationGraph.h"
+#include "UObject/ObjectKey.h"
+#include "BlasterReplicationGraph.generated.h"
+
+class AWeapon;
+class ABlasterCharacter;
+
+//how actors of a class get into the graph
+enum class EClassRepNodeMapping : uint32
+{
+	NotRouted,					//routed by hand, or only to their owner through the per connection node
+	RelevantAllConnections,		//always relevant, every connection gets them
+	Spatialize_Static,			//in the grid, never moves
+	Spatialize_Dynamic,			//in the grid, moves around and gets its cell updated every frame
+	Spatialize_Dormancy,		//in the grid, treated as static while dormant and as dynamic while awake
+};
+
+/**
+ * Replication graph for Blaster. Characters, projectiles, pickups and dropped weapons go in a 2D spatial grid, the game
+ * state and player states are always relevant, and an equipped weapon replicates as a dependent of the character holding it
+ */
+UCLASS(Transient, Config = Engine)
+class BLASTER_API UBlasterReplicationGraph : public UReplicationGraph
+{
+	GENERATED_BODY()
+
+public:
+	virtual void InitGlobalActorClassSettings() override;
+	virtual void InitGlobalGraphNodes() override;
+	virtual void InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection) override;
+	virtual void RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo) override;
+	virtual void RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo) override;
+
+	//the combat component calls these so the weapon follows its character instead of being looked up in the grid
+	static void NotifyWeaponEquipped(ABlasterCharacter* Character, AWeapon* Weapon);
+	static void NotifyWeaponDropped(ABlasterCharacter* Character, AWeapon* Weapon);
+
+	//the graph copies an actor's update rate when the actor is added, so anything changing NetUpdateFrequency at runtime calls this
+	static void NotifyNetUpdateFrequencyChanged(AActor* Actor);
+
+	UPROPERTY()
+	UReplicationGraphNode_GridSpatialization2D* GridNode;
+
+	UPROPERTY()
+	UReplicationGraphNode_ActorList* AlwaysRelevantNode;
+
+private:
+
+	static UBlasterReplicationGraph* Get(const UWorld* World);
+
+	EClassRepNodeMapping GetMappingPolicy(const UClass* Class);
+	void AddToGrid(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo, EClassRepNodeMapping Policy);
+	void RemoveFromGrid(const FNewReplicatedActorInfo& ActorInfo, EClassRepNodeMapping Policy);
+
+	TClassMap<EClassRepNodeMapping> ClassRepNodePolicies;
+
+	//weapons that are in the grid right now. A weapon only comes out of the grid if it went in, which one handed to a
+	//character as it spawned never did
+	TSet<TObjectKey<AWeapon>> WeaponsInGrid;
+
+	//size of one grid cell in cm
+	UPROPERTY(Config)
+	float GridCellSize = 10000.f;
+
+	//lowest corner of the map, the grid starts here so cells don't have to cover negative space
+	UPROPERTY(Config)
+	FVector2D GridSpatialBias = FVector2D(-150000.f, -150000.f);
+};
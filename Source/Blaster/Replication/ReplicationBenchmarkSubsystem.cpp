@@ -0,0 +1,159 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ReplicationBenchmarkSubsystem.h"
+#include "Engine/NetDriver.h"
+#include "Engine/ReplicationDriver.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/PlayerController.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "HAL/FileManager.h"
+
+bool UReplicationBenchmarkSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	UWorld* World = Cast<UWorld>(Outer);
+	if(World == nullptr || !World->IsGameWorld()) {return false;}
+
+	const TCHAR* CommandLine = FCommandLine::Get();
+	return FParse::Param(CommandLine, TEXT("RepBench")) || FParse::Param(CommandLine, TEXT("RepBenchBot"));
+}
+
+void UReplicationBenchmarkSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	const TCHAR* CommandLine = FCommandLine::Get();
+	bServer = FParse::Param(CommandLine, TEXT("RepBench"));
+	if(!bServer){
+		BotAngle = FMath::FRandRange(0.f, 360.f);
+		return;
+	}
+
+	FParse::Value(CommandLine, TEXT("RepBenchConnections="), NumConnections);
+	FParse::Value(CommandLine, TEXT("RepBenchWarmup="), WarmupTime);
+	FParse::Value(CommandLine, TEXT("RepBenchSeconds="), MeasureTime);
+	if(!FParse::Value(CommandLine, TEXT("RepBenchOut="), OutputPath)){
+		OutputPath = FPaths::ProjectSavedDir() / TEXT("RepBench.csv");
+	}
+
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &ThisClass::OnPostActorTick);
+	TickEndHandle = FWorldDelegates::OnWorldTickEnd.AddUObject(this, &ThisClass::OnWorldTickEnd);
+}
+
+void UReplicationBenchmarkSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+	FWorldDelegates::OnWorldTickEnd.Remove(TickEndHandle);
+
+	Super::Deinitialize();
+}
+
+TStatId UReplicationBenchmarkSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UReplicationBenchmarkSubsystem, STATGROUP_Tickables);
+}
+
+void UReplicationBenchmarkSubsystem::Tick(float DeltaTime)
+{
+	if(bServer){
+		TickServer(DeltaTime);
+	}
+	else{
+		TickBot(DeltaTime);
+	}
+}
+
+void UReplicationBenchmarkSubsystem::TickServer(float DeltaTime)
+{
+	UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	if(NetDriver == nullptr) {return;}
+
+	PhaseTime += DeltaTime;
+	switch(Phase){
+		case EBenchmarkPhase::WaitingForConnections:
+			if(NetDriver->ClientConnections.Num() >= NumConnections){
+				UE_LOG(LogTemp, Display, TEXT("RepBench: %d connections, warming up for %.0f s"), NetDriver->ClientConnections.Num(), WarmupTime);
+				Phase = EBenchmarkPhase::Warmup;
+				PhaseTime = 0.f;
+			}
+			break;
+		case EBenchmarkPhase::Warmup:
+			if(PhaseTime >= WarmupTime){
+				Phase = EBenchmarkPhase::Measuring;
+				PhaseTime = 0.f;
+				FlushTimes.Reset();
+			}
+			break;
+		case EBenchmarkPhase::Measuring:
+			if(PhaseTime >= MeasureTime){
+				Phase = EBenchmarkPhase::Done;
+				WriteResult();
+				FPlatformMisc::RequestExit(false);
+			}
+			break;
+		default:
+			break;
+	}
+}
+
+void UReplicationBenchmarkSubsystem::TickBot(float DeltaTime)
+{
+	APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+	ACharacter* Character = PlayerController ? Cast<ACharacter>(PlayerController->GetPawn()) : nullptr;
+	if(Character == nullptr) {return;}
+
+	//a full circle every ten seconds or so keeps the character crossing grid cells now and then
+	BotAngle = FMath::Fmod(BotAngle + 36.f * DeltaTime, 360.f);
+	Character->AddMovementInput(FRotator(0.f, BotAngle, 0.f).Vector());
+
+	BotTimeSinceJump += DeltaTime;
+	if(BotTimeSinceJump >= 3.f){
+		BotTimeSinceJump = 0.f;
+		Character->Jump();
+	}
+}
+
+void UReplicationBenchmarkSubsystem::OnPostActorTick(UWorld* World, ELevelTick TickType, float DeltaTime)
+{
+	if(World != GetWorld() || Phase != EBenchmarkPhase::Measuring) {return;}
+	FlushStartCycles = FPlatformTime::Cycles64();
+}
+
+void UReplicationBenchmarkSubsystem::OnWorldTickEnd(UWorld* World, ELevelTick TickType, float DeltaTime)
+{
+	if(World != GetWorld() || Phase != EBenchmarkPhase::Measuring || FlushStartCycles == 0) {return;}
+	FlushTimes.Add(FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - FlushStartCycles));
+	FlushStartCycles = 0;
+}
+
+void UReplicationBenchmarkSubsystem::WriteResult()
+{
+	UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	if(NetDriver == nullptr || FlushTimes.Num() == 0) {return;}
+
+	//the driver that actually ran goes in the row, so a run where the graph didn't load can't pass for a graph run
+	const UReplicationDriver* ReplicationDriver = NetDriver->GetReplicationDriver();
+	const FString DriverName = ReplicationDriver ? ReplicationDriver->GetClass()->GetName() : TEXT("Legacy");
+
+	TArray<float> Sorted = FlushTimes;
+	Sorted.Sort();
+	float Total = 0.f;
+	for(const float FlushTime : Sorted){
+		Total += FlushTime;
+	}
+	const float Mean = Total / Sorted.Num();
+	const float Median = Sorted[Sorted.Num() / 2];
+	const float P95 = Sorted[FMath::Min(FMath::FloorToInt(Sorted.Num() * 0.95f), Sorted.Num() - 1)];
+	const float Max = Sorted.Last();
+
+	FString Row;
+	if(!IFileManager::Get().FileExists(*OutputPath)){
+		Row += TEXT("Driver,Connections,Frames,MeanMs,MedianMs,P95Ms,MaxMs\n");
+	}
+	Row += FString::Printf(TEXT("%s,%d,%d,%.3f,%.3f,%.3f,%.3f\n"), *DriverName, NetDriver->ClientConnections.Num(), Sorted.Num(), Mean, Median, P95, Max);
+	FFileHelper::SaveStringToFile(Row, *OutputPath, FFileHelper::EEncodingOptions::ForceAnsi, &IFileManager::Get(), FILEWRITE_Append);
+
+	UE_LOG(LogTemp, Display, TEXT("RepBench: %s with %d connections, mean %.3f ms, median %.3f ms, p95 %.3f ms over %d frames"), *DriverName, NetDriver->ClientConnections.Num(), Mean, Median, P95, Sorted.Num());
+}
@@ -0,0 +1,67 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ReplicationBenchmarkSubsystem.generated.h"
+
+/**
+ * Server replication benchmark, only created when the command line asks for it. A server started with -RepBench waits for
+ * -RepBenchConnections= clients, lets the match settle for -RepBenchWarmup= seconds, then times the net driver's tick
+ * flush for -RepBenchSeconds= seconds. The result is appended as one row to the -RepBenchOut= file and the server exits.
+ * A client started with -RepBenchBot runs its character in circles so the server has moving characters to replicate.
+ * Scripts/RepGraphBenchmark.py starts the server and clients for every driver and connection count
+ */
+UCLASS()
+class BLASTER_API UReplicationBenchmarkSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+private:
+
+	enum class EBenchmarkPhase : uint8
+	{
+		WaitingForConnections,
+		Warmup,
+		Measuring,
+		Done
+	};
+
+	void TickServer(float DeltaTime);
+	void TickBot(float DeltaTime);
+
+	//these two bracket the net driver's tick flush, which is where the server replicates actors. Whatever else the
+	//engine runs between them is counted for both drivers alike
+	void OnPostActorTick(UWorld* World, ELevelTick TickType, float DeltaTime);
+	void OnWorldTickEnd(UWorld* World, ELevelTick TickType, float DeltaTime);
+
+	void WriteResult();
+
+	bool bServer = false;
+	EBenchmarkPhase Phase = EBenchmarkPhase::WaitingForConnections;
+	float PhaseTime = 0.f;
+
+	int32 NumConnections = 16;
+	float WarmupTime = 10.f;
+	float MeasureTime = 60.f;
+	FString OutputPath;
+
+	uint64 FlushStartCycles = 0;
+	//milliseconds every measured frame spent flushing
+	TArray<float> FlushTimes;
+
+	FDelegateHandle PostActorTickHandle;
+	FDelegateHandle TickEndHandle;
+
+	//bots start at a random point of their circle so they don't all move in step
+	float BotAngle = 0.f;
+	float BotTimeSinceJump = 0.f;
+};
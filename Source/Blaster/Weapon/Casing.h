@@ -6,6 +6,8 @@
 #include "GameFramework/Actor.h"
 #include "Casing.generated.h"
 
+class USoundCue;
+
 UCLASS()
 class BLASTER_API ACasing : public AActor
 {
@@ -14,6 +16,11 @@ class BLASTER_API ACasing : public AActor
 public:	
 	ACasing();
 
+	//the casing ejector reads these off the class defaults
+	FORCEINLINE UStaticMeshComponent* GetCasingMesh() const { return CasingMesh; }
+	FORCEINLINE float GetShellEjectionImpulse() const { return ShellEjectionImpulse; }
+	FORCEINLINE USoundCue* GetShellSound() const { return ShellSound; }
+
 protected:
 	virtual void BeginPlay() override;
 
@@ -28,7 +35,7 @@ private:
 	float ShellEjectionImpulse;
 
 	UPROPERTY(EditAnywhere)
-	class USoundCue* ShellSound;
+	USoundCue* ShellSound;
 
 
 };
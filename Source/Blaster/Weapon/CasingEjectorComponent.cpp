@@ -0,0 +1,145 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CasingEjectorComponent.h"
+#include "Casing.h"
+#include "Kismet/GameplayStatics.h"
+#include "Sound/SoundCue.h"
+#include "PhysicsEngine/BodySetup.h"
+
+UCasingEjectorComponent::UCasingEjectorComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	//only ticks while there are casings in the air or on the floor
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+
+	//instances are placed in world space, so the component itself must not follow the weapon around
+	SetUsingAbsoluteLocation(true);
+	SetUsingAbsoluteRotation(true);
+	SetUsingAbsoluteScale(true);
+
+	SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	SetCanEverAffectNavigation(false);
+	SetGenerateOverlapEvents(false);
+}
+
+void UCasingEjectorComponent::InitializeFromCasing(TSubclassOf<ACasing> CasingClass)
+{
+	const ACasing* DefaultCasing = CasingClass ? CasingClass->GetDefaultObject<ACasing>() : nullptr;
+	if(DefaultCasing == nullptr || DefaultCasing->GetCasingMesh() == nullptr) {return;}
+
+	UStaticMesh* CasingMesh = DefaultCasing->GetCasingMesh()->GetStaticMesh();
+	SetStaticMesh(CasingMesh);
+	ShellSound = DefaultCasing->GetShellSound();
+
+	//ACasing pushed a simulated body with an impulse, so turn that into the launch speed for a body of the same mass
+	float CasingMass = 1.f;
+	if(CasingMesh && CasingMesh->GetBodySetup()){
+		CasingMass = FMath::Max(CasingMesh->GetBodySetup()->CalculateMass(), KINDA_SMALL_NUMBER);
+	}
+	EjectionSpeed = DefaultCasing->GetShellEjectionImpulse() / CasingMass;
+}
+
+void UCasingEjectorComponent::EjectCasing(const FTransform &EjectTransform)
+{
+	//nobody sees casings on a dedicated server
+	if(GetNetMode() == NM_DedicatedServer || GetStaticMesh() == nullptr || MaxCasings <= 0) {return;}
+	UWorld* World = GetWorld();
+	if(World == nullptr) {return;}
+
+	if(Locations.Num() != MaxCasings){
+		Locations.SetNumZeroed(MaxCasings);
+		Velocities.SetNumZeroed(MaxCasings);
+		Rotations.SetNumZeroed(MaxCasings);
+		SpinRates.SetNumZeroed(MaxCasings);
+		FloorHeights.SetNumZeroed(MaxCasings);
+		RestTimesLeft.SetNumZeroed(MaxCasings);
+		bAlive.SetNumZeroed(MaxCasings);
+	}
+
+	const int32 Slot = NextSlot;
+	NextSlot = (NextSlot + 1) % MaxCasings;
+	if(!bAlive[Slot]){
+		NumAlive++;
+	}
+
+	//one trace at eject time instead of colliding every frame. Casings land on whatever was under the gun when it fired
+	const FVector EjectLocation = EjectTransform.GetLocation();
+	FHitResult FloorHit;
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(CasingFloor), false, GetOwner());
+	QueryParams.AddIgnoredActor(GetOwner() ? GetOwner()->GetOwner() : nullptr);
+	const bool bHitFloor = World->LineTraceSingleByChannel(FloorHit, EjectLocation, EjectLocation - FVector(0.f, 0.f, FloorTraceLength), ECollisionChannel::ECC_Visibility, QueryParams);
+
+	Locations[Slot] = EjectLocation;
+	Velocities[Slot] = EjectTransform.GetRotation().GetForwardVector() * EjectionSpeed;
+	Rotations[Slot] = EjectTransform.Rotator();
+	SpinRates[Slot] = FRotator(FMath::FRandRange(-MaxSpinRate, MaxSpinRate), FMath::FRandRange(-MaxSpinRate, MaxSpinRate), FMath::FRandRange(-MaxSpinRate, MaxSpinRate));
+	FloorHeights[Slot] = bHitFloor ? FloorHit.ImpactPoint.Z : EjectLocation.Z - FloorTraceLength;
+	RestTimesLeft[Slot] = -1.f;
+	bAlive[Slot] = true;
+	const FTransform InstanceTransform(Rotations[Slot], Locations[Slot]);
+
+	//instances are only ever added until the pool is full, after that slots are reused
+	if(InstanceTransforms.Num() <= Slot){
+		InstanceTransforms.Add(InstanceTransform);
+		AddInstance(InstanceTransform, true);
+	}
+	else{
+		InstanceTransforms[Slot] = InstanceTransform;
+		UpdateInstanceTransform(Slot, InstanceTransform, true, true, true);
+	}
+
+	SetComponentTickEnabled(true);
+}
+
+void UCasingEjectorComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	const float GravityZ = GetWorld()->GetGravityZ();
+	const int32 NumSlots = InstanceTransforms.Num();
+	for(int32 Slot = 0; Slot < NumSlots; ++Slot){
+		if(!bAlive[Slot]) {continue;}
+
+		//resting on the floor
+		if(RestTimesLeft[Slot] >= 0.f){
+			RestTimesLeft[Slot] -= DeltaTime;
+			if(RestTimesLeft[Slot] < 0.f){
+				HideCasing(Slot);
+			}
+			continue;
+		}
+
+		Velocities[Slot].Z += GravityZ * DeltaTime;
+		Locations[Slot] += Velocities[Slot] * DeltaTime;
+		Rotations[Slot] += SpinRates[Slot] * DeltaTime;
+
+		if(Locations[Slot].Z <= FloorHeights[Slot]){
+			Locations[Slot].Z = FloorHeights[Slot];
+			if(ShellSound){
+				UGameplayStatics::PlaySoundAtLocation(this, ShellSound, Locations[Slot]);
+			}
+			if(RestTime <= 0.f){
+				HideCasing(Slot);
+				continue;
+			}
+			RestTimesLeft[Slot] = RestTime;
+		}
+		InstanceTransforms[Slot] = FTransform(Rotations[Slot], Locations[Slot]);
+	}
+
+	//one render update for every casing that moved this frame
+	BatchUpdateInstancesTransforms(0, InstanceTransforms, true, true, true);
+
+	if(NumAlive == 0){
+		SetComponentTickEnabled(false);
+	}
+}
+
+void UCasingEjectorComponent::HideCasing(int32 Slot)
+{
+	bAlive[Slot] = false;
+	NumAlive--;
+	//zero scale keeps the instance around for the next casing without drawing anything
+	InstanceTransforms[Slot] = FTransform(FQuat::Identity, Locations[Slot], FVector::ZeroVector);
+}
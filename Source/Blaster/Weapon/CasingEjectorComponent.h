@@ -0,0 +1,74 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "CasingEjectorComponent.generated.h"
+
+/**
+ * Draws the shells a weapon ejects as instances of one mesh instead of spawning a physics ACasing actor per shot.
+ * Instances live in a fixed size pool in world space and fly with simple ballistics until they land on the floor that was
+ * found under them when they were ejected. When every slot is in use the oldest casing is recycled
+ */
+UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
+class BLASTER_API UCasingEjectorComponent : public UInstancedStaticMeshComponent
+{
+	GENERATED_BODY()
+
+public:
+	UCasingEjectorComponent();
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	//takes the mesh, sound and ejection impulse from the casing class defaults, so existing casing blueprints keep working
+	void InitializeFromCasing(TSubclassOf<class ACasing> CasingClass);
+
+	//ejects one casing along the forward vector of EjectTransform, which is the AmmoEject socket
+	void EjectCasing(const FTransform& EjectTransform);
+
+private:
+
+	UPROPERTY(EditAnywhere, Category = "Casings")
+	int32 MaxCasings = 32;
+
+	//how long a casing stays on the floor after landing before it disappears, 0 makes it vanish on contact like ACasing did
+	UPROPERTY(EditAnywhere, Category = "Casings")
+	float RestTime = 0.f;
+
+	//how far below the socket we look for the floor when a casing is ejected
+	UPROPERTY(EditAnywhere, Category = "Casings")
+	float FloorTraceLength = 1000.f;
+
+	//random tumble given to each casing, in degrees per second
+	UPROPERTY(EditAnywhere, Category = "Casings")
+	float MaxSpinRate = 720.f;
+
+	UPROPERTY()
+	class USoundCue* ShellSound;
+
+	float EjectionSpeed = 0.f;
+
+	void HideCasing(int32 Slot);
+
+	/**
+	 * Casing pool
+	 * One entry per instance, the instance index is the slot index
+	 */
+
+	TArray<FVector> Locations;
+	TArray<FVector> Velocities;
+	TArray<FRotator> Rotations;
+	TArray<FRotator> SpinRates;
+	TArray<float> FloorHeights;
+	//seconds left on the floor, negative while still in the air
+	TArray<float> RestTimesLeft;
+	TArray<bool> bAlive;
+
+	//slot the next casing goes into, which is also the oldest casing once the pool is full
+	int32 NextSlot = 0;
+	int32 NumAlive = 0;
+
+	//current transform of every instance that has been added so far, sent to the renderer in one batch each tick
+	TArray<FTransform> InstanceTransforms;
+};
@@ -9,8 +9,17 @@
 #include "Sound/SoundCue.h"
 #include "Kismet/KismetMathLibrary.h"
 #include "WeaponTypes.h"
+#include "Blaster/BlasterComponents/LagCompensationComponent.h"
+#include "Blaster/BlasterComponents/CombatComponent.h"
+#include "Blaster/PlayerController/BlasterPlayerController.h"
 
 void AHitScanWeapon::Fire(const FVector &HitTarget)
+{
+    //nothing gave us a seed, so this shot is only consistent on the machine that fires it
+    FireWithSeed(HitTarget, GetMuzzleLocation(), FMath::RandHelper(MAX_int32));
+}
+
+void AHitScanWeapon::FireWithSeed(const FVector &HitTarget, const FVector &TraceStart, int32 ScatterSeed)
 {
     Super::Fire(HitTarget);
 
@@ -18,87 +27,134 @@ void AHitScanWeapon::Fire(const FVector &HitTarget)
     if(OwnerPawn == nullptr) return;
     AController* InstigatorController = OwnerPawn->GetController(); //controller for the character firing the weapon
 
-    const USkeletalMeshSocket* MuzzleFlashSocket = GetWeaponMesh()->GetSocketByName("MuzzleFlash");
-    if(MuzzleFlashSocket){
-        FTransform SocketTransform = MuzzleFlashSocket->GetSocketTransform(GetWeaponMesh());
-        FVector Start = SocketTransform.GetLocation();
-
-        FHitResult FireHit;
-        UWorld* World = GetWorld();
-        WeaponTraceHit(Start, HitTarget, FireHit);
-        ABlasterCharacter* BlasterCharacter = Cast<ABlasterCharacter>(FireHit.GetActor());
-        if (BlasterCharacter && HasAuthority() && InstigatorController)
-        {
+    FVector End = TraceEndWithoutScatter(TraceStart, HitTarget);
+    if(bUseScatter){
+        TArray<FVector> TraceEnds;
+        TraceEndsWithScatter(TraceStart, HitTarget, ScatterSeed, 1, TraceEnds);
+        End = TraceEnds[0];
+    }
+
+    FHitResult FireHit;
+    UWorld* World = GetWorld();
+    WeaponTraceToEnd(TraceStart, End, FireHit);
+    ABlasterCharacter* BlasterCharacter = Cast<ABlasterCharacter>(FireHit.GetActor());
+    if (BlasterCharacter && InstigatorController)
+    {
+        //the server's own trace only counts when rewind is off or when the server is the one shooting
+        bool bCauseAuthDamage = !bUseServerSideRewind || OwnerPawn->IsLocallyControlled();
+        if(HasAuthority() && bCauseAuthDamage){
             UGameplayStatics::ApplyDamage(BlasterCharacter,	Damage,	InstigatorController, this, UDamageType::StaticClass());
         }
-        if (ImpactParticles)
-        {
-            UGameplayStatics::SpawnEmitterAtLocation(World, ImpactParticles, FireHit.ImpactPoint, FireHit.ImpactNormal.Rotation());
-        }
-        if(HitSound){
-            UGameplayStatics::PlaySoundAtLocation(this, HitSound, FireHit.ImpactPoint);
-        }
-        if(MuzzleFlash){
-            UGameplayStatics::SpawnEmitterAtLocation(World, MuzzleFlash, SocketTransform);
-        }
-        if(FireSound){
-            UGameplayStatics::PlaySoundAtLocation(this, FireSound, GetActorLocation());
+
+        ABlasterCharacter* OwnerCharacter = Cast<ABlasterCharacter>(OwnerPawn);
+        if(!HasAuthority() && bUseServerSideRewind && OwnerPawn->IsLocallyControlled() && OwnerCharacter && OwnerCharacter->GetLagCompensation() && OwnerCharacter->GetCombat()){
+            //the server scores this against the fire command it accepted for the shot, which has the trace start
+            const uint16 FireSequence = OwnerCharacter->GetCombat()->GetLastFireSequence();
+            OwnerCharacter->GetLagCompensation()->ServerScoreRequest(BlasterCharacter, FireHit.ImpactPoint, FireSequence, GetServerSideRewindHitTime(InstigatorController));
         }
     }
+    if (ImpactParticles)
+    {
+        UGameplayStatics::SpawnEmitterAtLocation(World, ImpactParticles, FireHit.ImpactPoint, FireHit.ImpactNormal.Rotation());
+    }
+    if(HitSound){
+        UGameplayStatics::PlaySoundAtLocation(this, HitSound, FireHit.ImpactPoint);
+    }
+    PlayMuzzleEffects();
+}
+
+void AHitScanWeapon::PlayMuzzleEffects()
+{
+    const USkeletalMeshSocket* MuzzleFlashSocket = GetWeaponMesh()->GetSocketByName("MuzzleFlash");
+    if(MuzzleFlash && MuzzleFlashSocket){
+        UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), MuzzleFlash, MuzzleFlashSocket->GetSocketTransform(GetWeaponMesh()));
+    }
+    if(FireSound){
+        UGameplayStatics::PlaySoundAtLocation(this, FireSound, GetActorLocation());
+    }
+}
+
+float AHitScanWeapon::GetServerSideRewindHitTime(AController *InstigatorController) const
+{
+    ABlasterPlayerController* BlasterController = Cast<ABlasterPlayerController>(InstigatorController);
+    if(BlasterController == nullptr){
+        return 0.f;
+    }
+    //simulated proxies on this client are about one trip behind the server
+    return BlasterController->GetServerTime() - BlasterController->SingleTripTime;
 }
 
-FVector AHitScanWeapon::TraceEndWithScatter(const FVector &TraceStart, const FVector &HitTarget)
+void AHitScanWeapon::TraceEndsWithScatter(const FVector &TraceStart, const FVector &HitTarget, int32 ScatterSeed, int32 NumTraces, TArray<FVector> &OutTraceEnds) const
 {
+    OutTraceEnds.SetNumUninitialized(NumTraces);
+    if(NumTraces <= 0) {return;}
+
     //this points to the hit target, but we want to set the length of it directly so it needs to be normalized
-    FVector ToTargetNormalized = (HitTarget - TraceStart).GetSafeNormal();
-    FVector SphereCenter = TraceStart + ToTargetNormalized * DistanceToSphere;
+    const FVector ToTargetNormalized = (HitTarget - TraceStart).GetSafeNormal();
+    const FVector ToSphereCenter = ToTargetNormalized * DistanceToSphere;
+
+    //the random numbers have to be drawn one after another from the stream so every machine gets the same sequence.
+    //they go into separate arrays per axis so the loop below that turns them into trace ends is plain float math
+    TArray<float, TInlineAllocator<32>> ToEndX, ToEndY, ToEndZ;
+    ToEndX.SetNumUninitialized(NumTraces);
+    ToEndY.SetNumUninitialized(NumTraces);
+    ToEndZ.SetNumUninitialized(NumTraces);
 
-    //selecting random locations within the sphere to use for line traces
-    FVector RandVec = UKismetMathLibrary::RandomUnitVector() * FMath::FRandRange(0.f, SphereRadius);
-    FVector EndLoc = SphereCenter + RandVec;
+    FRandomStream ScatterStream(ScatterSeed);
+    for(int32 i = 0; i < NumTraces; ++i){
+        //selecting random locations within the sphere to use for line traces
+        const FVector RandVec = ScatterStream.VRand() * ScatterStream.FRandRange(0.f, SphereRadius);
+        ToEndX[i] = ToSphereCenter.X + RandVec.X;
+        ToEndY[i] = ToSphereCenter.Y + RandVec.Y;
+        ToEndZ[i] = ToSphereCenter.Z + RandVec.Z;
+    }
 
-    //line to the end
-	FVector ToEndLoc = EndLoc - TraceStart;
+    //stretch every line from the start through its point in the sphere out to the trace length
+    for(int32 i = 0; i < NumTraces; ++i){
+        const float Scale = TRACE_LENGTH * FMath::InvSqrt(ToEndX[i] * ToEndX[i] + ToEndY[i] * ToEndY[i] + ToEndZ[i] * ToEndZ[i]);
+        ToEndX[i] *= Scale;
+        ToEndY[i] *= Scale;
+        ToEndZ[i] *= Scale;
+    }
 
-    // //showing what the shots and line traces look like
-	// DrawDebugSphere(GetWorld(), SphereCenter, SphereRadius, 12, FColor::Red, true);
-	// DrawDebugSphere(GetWorld(), EndLoc, 4.f, 12, FColor::Orange, true);
-	// DrawDebugLine(GetWorld(), TraceStart, FVector(TraceStart + ToEndLoc * TRACE_LENGTH / ToEndLoc.Size()), FColor::Cyan, true);
+    for(int32 i = 0; i < NumTraces; ++i){
+        OutTraceEnds[i] = FVector(TraceStart.X + ToEndX[i], TraceStart.Y + ToEndY[i], TraceStart.Z + ToEndZ[i]);
+    }
 
-	return FVector(TraceStart + ToEndLoc * TRACE_LENGTH / ToEndLoc.Size());
+    // //showing what the shots and line traces look like
+	// DrawDebugSphere(GetWorld(), TraceStart + ToSphereCenter, SphereRadius, 12, FColor::Red, true);
+	// for(const FVector& TraceEnd : OutTraceEnds) DrawDebugLine(GetWorld(), TraceStart, TraceEnd, FColor::Cyan, true);
 }
 
-void AHitScanWeapon::WeaponTraceHit(const FVector &TraceStart, const FVector &HitTarget, FHitResult &OutHit)
+void AHitScanWeapon::WeaponTraceToEnd(const FVector &TraceStart, const FVector &TraceEnd, FHitResult &OutHit)
 {
     UWorld* World = GetWorld();
 	if (World)
 	{
-		FVector End = bUseScatter ? TraceEndWithScatter(TraceStart, HitTarget) : TraceStart + (HitTarget - TraceStart) * 1.25f;
-
 		World->LineTraceSingleByChannel(
 			OutHit,
 			TraceStart,
-			End,
+			TraceEnd,
 			ECollisionChannel::ECC_Visibility
 		);
-		FVector BeamEnd = End;
-		if (OutHit.bBlockingHit)
-		{
-			BeamEnd = OutHit.ImpactPoint;
-		}
-		if (BeamParticles)
+		SpawnBeam(TraceStart, OutHit.bBlockingHit ? FVector(OutHit.ImpactPoint) : TraceEnd);
+	}
+}
+
+void AHitScanWeapon::SpawnBeam(const FVector &TraceStart, const FVector &BeamEnd)
+{
+	if (BeamParticles && ShouldPlayDetailEffects())
+	{
+		UParticleSystemComponent* Beam = UGameplayStatics::SpawnEmitterAtLocation(
+			GetWorld(),
+			BeamParticles,
+			TraceStart,
+			FRotator::ZeroRotator,
+			true
+		);
+		if (Beam)
 		{
-			UParticleSystemComponent* Beam = UGameplayStatics::SpawnEmitterAtLocation(
-				World,
-				BeamParticles,
-				TraceStart,
-				FRotator::ZeroRotator,
-				true
-			);
-			if (Beam)
-			{
-				Beam->SetVectorParameter(FName("Target"), BeamEnd);
-			}
+			Beam->SetVectorParameter(FName("Target"), BeamEnd);
 		}
 	}
 }
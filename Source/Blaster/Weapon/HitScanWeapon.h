@@ -16,11 +16,37 @@ class BLASTER_API AHitScanWeapon : public AWeapon
 
 public:
 	virtual void Fire(const FVector& HitTarget) override;
+	virtual void FireWithSeed(const FVector& HitTarget, const FVector& TraceStart, int32 ScatterSeed) override;
+	virtual bool UsesFireSeed() const override { return bUseScatter; }
+
+	//fills OutTraceEnds with NumTraces scattered trace ends. The same seed gives the same ends on every machine
+	void TraceEndsWithScatter(const FVector& TraceStart, const FVector& HitTarget, int32 ScatterSeed, int32 NumTraces, TArray<FVector>& OutTraceEnds) const;
+
+	FORCEINLINE float GetDamage() const { return Damage; }
+	FORCEINLINE bool UsesServerSideRewind() const { return bUseServerSideRewind; }
 
 protected:
-	FVector TraceEndWithScatter(const FVector& TraceStart, const FVector& HitTarget);
+	//line trace from TraceStart to TraceEnd that also draws the beam
+	void WeaponTraceToEnd(const FVector& TraceStart, const FVector& TraceEnd, FHitResult& OutHit);
+
+	void SpawnBeam(const FVector& TraceStart, const FVector& BeamEnd);
+
+	//where the shot ends up when the weapon does not scatter
+	FORCEINLINE FVector TraceEndWithoutScatter(const FVector& TraceStart, const FVector& HitTarget) const { return TraceStart + (HitTarget - TraceStart) * 1.25f; }
+
+	void PlayMuzzleEffects();
+
+	//the server time the owning client was looking at when it fired, this is what the server rewinds to
+	float GetServerSideRewindHitTime(AController* InstigatorController) const;
+
+	/**
+	 * Server-side rewind
+	 * When this is on, the server does not score hits from its own trace of a client's shot. The shooting client traces
+	 * locally and sends a score request that the server checks against the hit boxes as they were when the client fired
+	 */
 
-	void WeaponTraceHit(const FVector& TraceStart, const FVector& HitTarget, FHitResult& OutHit);
+	UPROPERTY(EditAnywhere, Category = "Server-Side Rewind")
+	bool bUseServerSideRewind = true;
 
 	UPROPERTY(EditAnywhere)
 	class UParticleSystem* ImpactParticles;
@@ -9,6 +9,11 @@
 #include "Sound/SoundCue.h"
 #include "Blaster/Character/BlasterCharacter.h"
 #include "Blaster/Blaster.h"
+#include "Net/UnrealNetwork.h"
+#include "Particles/ParticleSystemComponent.h"
+#include "GameFramework/ProjectileMovementComponent.h"
+#include "ProjectilePoolSubsystem.h"
+#include "Blaster/BlasterComponents/CombatComponent.h"
 
 AProjectile::AProjectile()
 {
@@ -31,30 +36,234 @@ void AProjectile::BeginPlay()
 {
 	Super::BeginPlay();
 	
-	if(Tracer){
+	if(HasAuthority()){
+		CollisionBox->OnComponentHit.AddDynamic(this, &ThisClass::OnHit);
+	}
+	InitializePoolState();
+}
+
+void AProjectile::GetLifetimeReplicatedProps(TArray<FLifetimeProperty> &OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(AProjectile, PoolState);
+	//only the shooter has a predicted copy to match it with
+	DOREPLIFETIME_CONDITION(AProjectile, ShotId, COND_OwnerOnly);
+}
+
+void AProjectile::OnHit(UPrimitiveComponent *HitComp, AActor *OtherActor, UPrimitiveComponent *OtherComp, FVector NormalImpulse, const FHitResult &Hit)
+{
+	//FinishProjectile sends the projectile back to the pool and PoolState tells the clients to play the impact
+	//THIS IS IMPORTANT because it will propagate the particles and sounds down to the clients
+	FinishProjectile();
+}
+
+void AProjectile::InitializePoolState()
+{
+	//the pool spawns projectiles already idle, everything else is spawned to fly straight away like before
+	if(PoolState.bActive){
+		LocalGeneration = PoolState.Generation;
+		LaunchProjectile();
+		if(!HasAuthority()){
+			ReconcileWithPrediction();
+		}
+	}
+	else{
+		EndFlight();
+	}
+}
+
+void AProjectile::MarkCosmeticOnly(int32 PredictedShotId)
+{
+	bCosmeticOnly = true;
+	ShotId = PredictedShotId;
+}
+
+void AProjectile::ReconcileWithPrediction()
+{
+	ABlasterCharacter* OwnerCharacter = Cast<ABlasterCharacter>(GetOwner());
+	if(OwnerCharacter == nullptr || !OwnerCharacter->IsLocallyControlled() || OwnerCharacter->GetCombat() == nullptr) {return;}
+
+	AProjectile* PredictedProjectile = OwnerCharacter->GetCombat()->TakePredictedProjectile(ShotId);
+	if(PredictedProjectile == nullptr) {return;}
+
+	if(PredictedProjectile->bCosmeticImpacted){
+		//the player already saw this shot land, so the server copy stays out of sight and doesn't play its impact again
+		bSuppressImpact = true;
+		HideProjectile();
+	}
+	else{
+		//carry on from where the player sees the shot instead of jumping back to where the server launched it
+		SetActorLocationAndRotation(PredictedProjectile->GetActorLocation(), PredictedProjectile->GetActorRotation());
+		UProjectileMovementComponent* ProjectileMovement = GetProjectileMovement();
+		UProjectileMovementComponent* PredictedMovement = PredictedProjectile->GetProjectileMovement();
+		if(ProjectileMovement && PredictedMovement){
+			ProjectileMovement->Velocity = PredictedMovement->Velocity;
+			ProjectileMovement->UpdateComponentVelocity();
+		}
+	}
+	PredictedProjectile->Destroy();
+}
+
+void AProjectile::MarkPooledIdle()
+{
+	bPooled = true;
+	PoolState.bActive = false;
+	//nobody needs to hear about a projectile until it is first launched, ActivateFromPool wakes it up
+	NetDormancy = DORM_DormantAll;
+}
+
+void AProjectile::ActivateFromPool(const FVector &Location, const FRotator &Rotation, AActor *NewOwner, APawn *NewInstigator)
+{
+	SetOwner(NewOwner);
+	SetInstigator(NewInstigator);
+	SetActorLocationAndRotation(Location, Rotation);
+
+	//awake before the new state is set, so the state change goes out on a reopened channel instead of being lost
+	SetNetDormancy(DORM_Awake);
+	PoolState.bActive = true;
+	PoolState.Generation++;
+	PoolState.LaunchLocation = Location;
+	PoolState.LaunchRotation = Rotation;
+
+	LocalGeneration = PoolState.Generation;
+	LaunchProjectile();
+	ForceNetUpdate();
+}
+
+void AProjectile::DeactivateFromPool()
+{
+	PoolState.bActive = false;
+	PoolState.ImpactLocation = GetActorLocation();
+
+	ImpactProjectile();
+	EndFlight();
+	ForceNetUpdate();
+	//a channel going dormant replicates once more and waits for the changes to be acked before it closes, so the
+	//impact above still reaches everyone. After that a parked projectile isn't looked at again until it is reused
+	SetNetDormancy(DORM_DormantAll);
+}
+
+void AProjectile::EndFlight()
+{
+	bLocallyActive = false;
+	HideProjectile();
+}
+
+void AProjectile::FinishProjectile()
+{
+	//a predicted copy plays its impact and waits out of sight for the server copy, which will look it up to see it already landed
+	if(bCosmeticOnly){
+		if(!bCosmeticImpacted){
+			bCosmeticImpacted = true;
+			ImpactProjectile();
+			HideProjectile();
+		}
+		return;
+	}
+	if(!HasAuthority()) {return;}
+
+	UProjectilePoolSubsystem* ProjectilePool = bPooled ? GetWorld()->GetSubsystem<UProjectilePoolSubsystem>() : nullptr;
+	if(ProjectilePool){
+		ProjectilePool->ReleaseProjectile(this);
+	}
+	else{
+		//Destroy will end up calling our override of Destroyed, which plays the impact on every machine
+		Destroy();
+	}
+}
+
+void AProjectile::OnRep_PoolState()
+{
+	//BeginPlay sets up the first state itself
+	if(!HasActorBegunPlay()) {return;}
+	ApplyPoolState();
+}
+
+void AProjectile::ApplyPoolState()
+{
+	const bool bNewFlight = PoolState.bActive && PoolState.Generation != LocalGeneration;
+	if(bLocallyActive && (!PoolState.bActive || bNewFlight)){
+		//if we missed the impact entirely and are already on the next flight, the old impact location is gone
+		if(!PoolState.bActive && !bSuppressImpact){
+			SetActorLocation(PoolState.ImpactLocation);
+			ImpactProjectile();
+		}
+		EndFlight();
+	}
+	if(PoolState.bActive && !bLocallyActive){
+		SetActorLocationAndRotation(PoolState.LaunchLocation, PoolState.LaunchRotation);
+		LocalGeneration = PoolState.Generation;
+		LaunchProjectile();
+		ReconcileWithPrediction();
+	}
+}
+
+void AProjectile::LaunchProjectile()
+{
+	bLocallyActive = true;
+	bSuppressImpact = false;
+
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+	CollisionBox->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
+
+	//the movement component let go of the collision box when it stopped, so hook it back up and start it over
+	UProjectileMovementComponent* ProjectileMovement = GetProjectileMovement();
+	if(ProjectileMovement){
+		ProjectileMovement->SetUpdatedComponent(CollisionBox);
+		ProjectileMovement->Velocity = GetActorForwardVector() * ProjectileMovement->InitialSpeed;
+		ProjectileMovement->UpdateComponentVelocity();
+		ProjectileMovement->Activate(true);
+	}
+
+	StartTracer();
+}
+
+void AProjectile::StartTracer()
+{
+	if(TracerComponent){
+		TracerComponent->Activate(true);
+	}
+	else if(Tracer){
 		TracerComponent = UGameplayStatics::SpawnEmitterAttached(Tracer,
 																 CollisionBox,//we are attaching the Tracer to the collision box
 																 FName(),
 																 GetActorLocation(),
 																 GetActorRotation(),
-																 EAttachLocation::KeepWorldPosition //so that the bullet doesn't continue to rotate with the gun after firing
+																 EAttachLocation::KeepWorldPosition, //so that the bullet doesn't continue to rotate with the gun after firing
+																 false //the tracer gets reused for every flight out of the pool
 																);
 	}
-	if(HasAuthority()){
-		CollisionBox->OnComponentHit.AddDynamic(this, &ThisClass::OnHit);
-	}
 }
 
-void AProjectile::OnHit(UPrimitiveComponent *HitComp, AActor *OtherActor, UPrimitiveComponent *OtherComp, FVector NormalImpulse, const FHitResult &Hit)
+void AProjectile::HideProjectile()
 {
-	//Destroy will end up calling our override of Destroyed
-	//THIS IS IMPORTANT because it will propagate the particles and sounds down to the clients
-	Destroy();
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+	GetWorldTimerManager().ClearTimer(DestroyTimer);
+
+	UProjectileMovementComponent* ProjectileMovement = GetProjectileMovement();
+	if(ProjectileMovement){
+		ProjectileMovement->StopMovementImmediately();
+		ProjectileMovement->Deactivate();
+	}
+	if(TracerComponent){
+		TracerComponent->DeactivateImmediate();
+	}
+	if(TrailSystemComponent){
+		TrailSystemComponent->DeactivateImmediate();
+	}
 }
 
 void AProjectile::SpawnTrailSystem()
 {
-	if (TrailSystem)
+	if (TrailSystemComponent)
+	{
+		//reused from an earlier flight out of the pool
+		TrailSystemComponent->Activate(true);
+	}
+	else if (TrailSystem)
 	{
 		TrailSystemComponent = UNiagaraFunctionLibrary::SpawnSystemAttached(
 			TrailSystem,
@@ -71,7 +280,7 @@ void AProjectile::SpawnTrailSystem()
 void AProjectile::ExplodeDamage()
 {
 	APawn* FiringPawn = GetInstigator();
-	if (FiringPawn && HasAuthority())
+	if (FiringPawn && HasAuthority() && !bCosmeticOnly)
 	{
 		AController* FiringController = FiringPawn->GetController();
 		if (FiringController)
@@ -111,7 +320,7 @@ void AProjectile::StartDestroyTimer()
 
 void AProjectile::DestroyTimerFinished()
 {
-	Destroy();
+	FinishProjectile();
 }
 
 void AProjectile::Destroyed()
@@ -119,7 +328,15 @@ void AProjectile::Destroyed()
 	Super::Destroyed();
 
 	//this function is being propagated down to clients since we are calling it on the server
+	//projectiles sitting in the pool are only destroyed when the level goes away, and they have nothing to play.
+	//predicted copies already played their impact in FinishProjectile, if they got that far
+	if(bLocallyActive && !bCosmeticOnly && !bSuppressImpact){
+		ImpactProjectile();
+	}
+}
 
+void AProjectile::ImpactProjectile()
+{
 	if(ImpactParticles){
 		UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ImpactParticles, GetActorTransform());
 	}
@@ -6,6 +6,29 @@
 #include "GameFramework/Actor.h"
 #include "Projectile.generated.h"
 
+//what a client needs to know to show a pooled projectile being launched and to play its impact when it goes back to the pool
+USTRUCT()
+struct FProjectilePoolState
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	bool bActive = true;
+
+	//bumped every launch, so a client can tell a new flight from the one it is already showing
+	UPROPERTY()
+	uint8 Generation = 0;
+
+	UPROPERTY()
+	FVector_NetQuantize LaunchLocation;
+
+	UPROPERTY()
+	FRotator LaunchRotation;
+
+	UPROPERTY()
+	FVector_NetQuantize ImpactLocation;
+};
+
 UCLASS()
 class BLASTER_API AProjectile : public AActor
 {
@@ -18,6 +41,31 @@ public:
 
 	virtual void Destroyed() override;
 
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	/**
+	 * Projectile pool
+	 * These are only called on the server by UProjectilePoolSubsystem
+	 */
+
+	//makes a freshly spawned projectile start out sitting in the pool instead of flying, must be called before FinishSpawning
+	void MarkPooledIdle();
+	void ActivateFromPool(const FVector& Location, const FRotator& Rotation, AActor* NewOwner, APawn* NewInstigator);
+	void DeactivateFromPool();
+
+	FORCEINLINE bool IsPoolActive() const { return PoolState.bActive; }
+
+	/**
+	 * Predicted projectiles
+	 * The owning client spawns its own copy of the shot right away. That copy never does damage and is thrown away as soon as
+	 * the server copy with the same ShotId shows up
+	 */
+
+	//must be called before FinishSpawning on the owning client's local copy
+	void MarkCosmeticOnly(int32 PredictedShotId);
+	FORCEINLINE void SetShotId(int32 NewShotId) { ShotId = NewShotId; }
+	FORCEINLINE bool IsCosmeticOnly() const { return bCosmeticOnly; }
+
 protected:
 	virtual void BeginPlay() override;
 
@@ -26,6 +74,28 @@ protected:
 	void SpawnTrailSystem();
 	void ExplodeDamage();
 
+	//ends the flight on the server, going back to the pool if the projectile came from one or being destroyed if not
+	void FinishProjectile();
+
+	//BeginPlay calls this to either start flying or hide in the pool, depending on the state the projectile was spawned with
+	void InitializePoolState();
+	//stops showing this flight and marks the projectile as sitting in the pool on this machine
+	void EndFlight();
+
+	//on the owning client, swaps the predicted copy of this shot for this one
+	void ReconcileWithPrediction();
+
+	//shows the projectile and starts it moving from where it is now along its forward vector
+	virtual void LaunchProjectile();
+	//plays the impact sounds and particles, this is what used to happen in Destroyed
+	virtual void ImpactProjectile();
+	//hides the projectile and stops everything it does while it waits in the pool
+	virtual void HideProjectile();
+	virtual void StartTracer();
+
+	//rockets move with their own movement component, so everything that resets movement goes through this
+	virtual class UProjectileMovementComponent* GetProjectileMovement() const { return ProjectileMovementComponent; }
+
 	UFUNCTION()
 	virtual void OnHit(UPrimitiveComponent* HitComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit);
 
@@ -75,6 +145,34 @@ private:
 	UPROPERTY(EditAnywhere)
 	float DestroyTime = 3.f;
 
+	UPROPERTY(ReplicatedUsing = OnRep_PoolState)
+	FProjectilePoolState PoolState;
+
+	UFUNCTION()
+	void OnRep_PoolState();
+
+	//brings this machine's copy in line with PoolState
+	void ApplyPoolState();
+
+	//true if this projectile belongs to the pool and should go back to it instead of being destroyed
+	bool bPooled = false;
+
+	//what this machine is currently showing, compared against PoolState on clients
+	bool bLocallyActive = false;
+	uint8 LocalGeneration = 0;
+
+	//set for the current flight when the owner's predicted copy already played the impact
+	bool bSuppressImpact = false;
+
+protected:
+	//matches the server copy of a shot with the predicted copy the shooter spawned
+	UPROPERTY(Replicated)
+	int32 ShotId = 0;
+
+	bool bCosmeticOnly = false;
+	//the predicted copy hit something before the server copy arrived
+	bool bCosmeticImpacted = false;
+
 public:	
 
 };
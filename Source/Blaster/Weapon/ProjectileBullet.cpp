@@ -15,7 +15,8 @@ AProjectileBullet::AProjectileBullet(){
 void AProjectileBullet::OnHit(UPrimitiveComponent* HitComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit)
 {
 	ACharacter* OwnerCharacter = Cast<ACharacter>(GetOwner());
-	if (OwnerCharacter)
+	//the predicted copy on the shooting client never does damage
+	if (OwnerCharacter && !bCosmeticOnly)
 	{
 		AController* OwnerController = OwnerCharacter->Controller;
 		if (OwnerController)
@@ -19,10 +19,22 @@ void AProjectileGrenade::BeginPlay()
 {
 	AActor::BeginPlay();
 
+	ProjectileMovementComponent->OnProjectileBounce.AddDynamic(this, &AProjectileGrenade::OnBounce);
+
+	InitializePoolState();
+}
+
+void AProjectileGrenade::LaunchProjectile()
+{
+	Super::LaunchProjectile();
+
 	SpawnTrailSystem();
 	StartDestroyTimer();
+}
 
-	ProjectileMovementComponent->OnProjectileBounce.AddDynamic(this, &AProjectileGrenade::OnBounce);
+void AProjectileGrenade::StartTracer()
+{
+	//grenades only have the trail system, never a tracer
 }
 
 void AProjectileGrenade::OnBounce(const FHitResult& ImpactResult, const FVector& ImpactVelocity)
@@ -37,8 +49,8 @@ void AProjectileGrenade::OnBounce(const FHitResult& ImpactResult, const FVector&
 	}
 }
 
-void AProjectileGrenade::Destroyed()
+void AProjectileGrenade::ImpactProjectile()
 {
 	ExplodeDamage();
-	Super::Destroyed();
+	Super::ImpactProjectile();
 }
\ No newline at end of file
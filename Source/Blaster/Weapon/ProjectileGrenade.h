@@ -16,10 +16,13 @@ class BLASTER_API AProjectileGrenade : public AProjectile
 
 public:
 	AProjectileGrenade();
-	virtual void Destroyed() override;
 protected:
 	virtual void BeginPlay() override;
 
+	virtual void LaunchProjectile() override;
+	virtual void ImpactProjectile() override;
+	virtual void StartTracer() override;
+
 	UFUNCTION()
 	void OnBounce(const FHitResult& ImpactResult, const FVector& ImpactVelocity);
 private:
@@ -0,0 +1,86 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ProjectilePoolSubsystem.h"
+#include "Projectile.h"
+#include "Blaster/Blaster.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Projectiles Reused"), STAT_ProjectilePoolReused, STATGROUP_Blaster);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Projectiles Spawned"), STAT_ProjectilePoolSpawned, STATGROUP_Blaster);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Projectiles Idle"), STAT_ProjectilePoolIdle, STATGROUP_Blaster);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Projectile Pool Hit Rate %"), STAT_ProjectilePoolHitRate, STATGROUP_Blaster);
+
+bool UProjectilePoolSubsystem::ShouldCreateSubsystem(UObject *Outer) const
+{
+    //only game worlds fire projectiles, the editor world doesn't need a pool
+    UWorld* World = Cast<UWorld>(Outer);
+    return World && World->IsGameWorld() && Super::ShouldCreateSubsystem(Outer);
+}
+
+AProjectile* UProjectilePoolSubsystem::AcquireProjectile(TSubclassOf<AProjectile> ProjectileClass, const FVector &Location, const FRotator &Rotation, AActor *Owner, APawn *Instigator)
+{
+    if(ProjectileClass == nullptr || GetWorld()->GetNetMode() == NM_Client) {return nullptr;}
+
+    AProjectile* Projectile = nullptr;
+    FProjectilePool& Pool = Pools.FindOrAdd(ProjectileClass);
+    while(Projectile == nullptr && Pool.Free.Num() > 0){
+        //anything destroyed out from under us (level change, kill volume) is just skipped
+        AProjectile* Candidate = Pool.Free.Pop(false);
+        if(IsValid(Candidate)){
+            Projectile = Candidate;
+            DEC_DWORD_STAT(STAT_ProjectilePoolIdle);
+        }
+    }
+
+    NumAcquired++;
+    if(Projectile){
+        NumReused++;
+        INC_DWORD_STAT(STAT_ProjectilePoolReused);
+    }
+    else{
+        Projectile = SpawnIdleProjectile(ProjectileClass);
+        INC_DWORD_STAT(STAT_ProjectilePoolSpawned);
+    }
+    SET_FLOAT_STAT(STAT_ProjectilePoolHitRate, 100.f * NumReused / NumAcquired);
+
+    if(Projectile){
+        Projectile->ActivateFromPool(Location, Rotation, Owner, Instigator);
+    }
+    return Projectile;
+}
+
+void UProjectilePoolSubsystem::ReleaseProjectile(AProjectile *Projectile)
+{
+    if(!IsValid(Projectile) || !Projectile->IsPoolActive()) {return;}
+
+    Projectile->DeactivateFromPool();
+    Pools.FindOrAdd(Projectile->GetClass()).Free.Add(Projectile);
+    INC_DWORD_STAT(STAT_ProjectilePoolIdle);
+}
+
+void UProjectilePoolSubsystem::PrewarmProjectiles(TSubclassOf<AProjectile> ProjectileClass, int32 Count)
+{
+    if(ProjectileClass == nullptr || GetWorld()->GetNetMode() == NM_Client) {return;}
+
+    FProjectilePool& Pool = Pools.FindOrAdd(ProjectileClass);
+    while(Pool.Free.Num() < Count){
+        AProjectile* Projectile = SpawnIdleProjectile(ProjectileClass);
+        if(Projectile == nullptr) {return;}
+        Pool.Free.Add(Projectile);
+        INC_DWORD_STAT(STAT_ProjectilePoolIdle);
+    }
+}
+
+AProjectile* UProjectilePoolSubsystem::SpawnIdleProjectile(TSubclassOf<AProjectile> ProjectileClass)
+{
+    UWorld* World = GetWorld();
+    if(World == nullptr) {return nullptr;}
+
+    //deferred so the projectile knows it belongs to the pool before BeginPlay decides whether it should fly
+    AProjectile* Projectile = World->SpawnActorDeferred<AProjectile>(ProjectileClass, FTransform::Identity, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+    if(Projectile){
+        Projectile->MarkPooledIdle();
+        Projectile->FinishSpawning(FTransform::Identity);
+    }
+    return Projectile;
+}
@@ -0,0 +1,52 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ProjectilePoolSubsystem.generated.h"
+
+class AProjectile;
+
+USTRUCT()
+struct FProjectilePool
+{
+	GENERATED_BODY()
+
+	//projectiles of one class that are sitting idle and ready to be launched
+	UPROPERTY()
+	TArray<AProjectile*> Free;
+};
+
+/**
+ * Keeps spent projectiles around on the server so firing reuses them instead of spawning a new actor for every shot.
+ * Clients never touch the pool, they just see the replicated projectiles being shown and hidden
+ */
+UCLASS()
+class BLASTER_API UProjectilePoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	//launches an idle projectile of ProjectileClass from Location, spawning a new one only if the pool for that class is empty
+	AProjectile* AcquireProjectile(TSubclassOf<AProjectile> ProjectileClass, const FVector& Location, const FRotator& Rotation, AActor* Owner, APawn* Instigator);
+
+	//plays the impact and puts the projectile back in its pool
+	void ReleaseProjectile(AProjectile* Projectile);
+
+	//spawns idle projectiles until the pool for ProjectileClass holds at least Count of them
+	void PrewarmProjectiles(TSubclassOf<AProjectile> ProjectileClass, int32 Count);
+
+private:
+
+	AProjectile* SpawnIdleProjectile(TSubclassOf<AProjectile> ProjectileClass);
+
+	UPROPERTY()
+	TMap<TSubclassOf<AProjectile>, FProjectilePool> Pools;
+
+	//only used for the hit rate stat
+	uint32 NumAcquired = 0;
+	uint32 NumReused = 0;
+};
@@ -20,10 +20,15 @@ AProjectileRocket::AProjectileRocket(){
 	RocketMovementComponent->SetIsReplicated(true);
 }
 
-void AProjectileRocket::Destroyed()
+void AProjectileRocket::ImpactProjectile()
 {
-    //we don't want to call Super::Destroy because we are handling the spawning of the sounds and particles in here
-    //differently than we would for a normal projectile
+    //we don't want to call Super::ImpactProjectile because we are handling the spawning of the sounds and particles in
+    //OnHit differently than we would for a normal projectile
+}
+
+UProjectileMovementComponent* AProjectileRocket::GetProjectileMovement() const
+{
+    return RocketMovementComponent;
 }
 
 void AProjectileRocket::OnHit(UPrimitiveComponent *HitComp, AActor *OtherActor, UPrimitiveComponent *OtherComp, FVector NormalImpulse, const FHitResult &Hit)
@@ -33,6 +38,13 @@ void AProjectileRocket::OnHit(UPrimitiveComponent *HitComp, AActor *OtherActor,
 		return;
 	}
 
+    if(bCosmeticOnly)
+    {
+        //the shooter's predicted copy only plays the explosion below, ExplodeDamage skips cosmetic copies so the radial
+        //damage comes from the server copy alone. Marking it impacted tells the server copy to hide and not play its own
+        bCosmeticImpacted = true;
+    }
+
     ExplodeDamage();
 
     //we don't want to destroy OnHit, since we want the smoke trail to linger after the rocket explodes
@@ -77,10 +89,25 @@ void AProjectileRocket::BeginPlay()
         //all the client projectile OnHit functions so we will have hit events for rockets on all machines
 		CollisionBox->OnComponentHit.AddDynamic(this, &ThisClass::OnHit);
 	}
+}
+
+void AProjectileRocket::LaunchProjectile()
+{
+	Super::LaunchProjectile();
+
+	//OnHit hid all of this at the end of the last flight out of the pool
+	if (ProjectileMesh)
+	{
+		ProjectileMesh->SetVisibility(true);
+	}
 
 	SpawnTrailSystem();
 
-	if (ProjectileLoop && LoopingSoundAttenuation)
+	if (ProjectileLoopComponent)
+	{
+		ProjectileLoopComponent->Play();
+	}
+	else if (ProjectileLoop && LoopingSoundAttenuation)
 	{
 		ProjectileLoopComponent = UGameplayStatics::SpawnSoundAttached(
 			ProjectileLoop,
@@ -98,3 +125,13 @@ void AProjectileRocket::BeginPlay()
 		);
 	}
 }
+
+void AProjectileRocket::HideProjectile()
+{
+	Super::HideProjectile();
+
+	if (ProjectileLoopComponent && ProjectileLoopComponent->IsPlaying())
+	{
+		ProjectileLoopComponent->Stop();
+	}
+}
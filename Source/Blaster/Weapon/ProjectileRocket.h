@@ -16,13 +16,17 @@ class BLASTER_API AProjectileRocket : public AProjectile
 
 public:
 	AProjectileRocket();
-	virtual void Destroyed() override;
 
 protected:
 	virtual void OnHit(UPrimitiveComponent* HitComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit) override;
 
 	virtual void BeginPlay() override;
 
+	virtual void LaunchProjectile() override;
+	virtual void ImpactProjectile() override;
+	virtual void HideProjectile() override;
+	virtual class UProjectileMovementComponent* GetProjectileMovement() const override;
+
 	UPROPERTY(EditAnywhere)
 	USoundCue* ProjectileLoop;
 
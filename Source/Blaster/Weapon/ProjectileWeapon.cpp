@@ -4,18 +4,24 @@
 #include "ProjectileWeapon.h"
 #include "Engine/SkeletalMeshSocket.h"
 #include "Projectile.h"
+#include "ProjectilePoolSubsystem.h"
+#include "Blaster/Character/BlasterCharacter.h"
+#include "Blaster/BlasterComponents/CombatComponent.h"
 
-void AProjectileWeapon::Fire(const FVector &HitTarget)
+void AProjectileWeapon::FireWithSeed(const FVector &HitTarget, const FVector &TraceStart, int32 ScatterSeed)
 {
     Super::Fire(HitTarget);
 
-    //this is to make sure we are only spawning the projectile on the server
-    if(!HasAuthority()){
+    //the server spawns the real projectile, and only the client that fired gets a predicted copy of it
+    APawn* InstigatorPawn = Cast<APawn>(GetOwner());
+    if(InstigatorPawn == nullptr){
+        return;
+    }
+    const bool bPredict = !HasAuthority() && bPredictProjectiles && InstigatorPawn->IsLocallyControlled();
+    if(!HasAuthority() && !bPredict){
         return;
     }
 
-    //this might be the ProjectileWeapon?
-    APawn* InstigatorPawn = Cast<APawn>(GetOwner());
     //GetWeaponMesh is a parent function
     const USkeletalMeshSocket* MuzzleFlashSocket = GetWeaponMesh()->GetSocketByName(FName("MuzzleFlash"));
     if(MuzzleFlashSocket){
@@ -24,15 +30,19 @@ void AProjectileWeapon::Fire(const FVector &HitTarget)
         //From the muzzle flash socket to hit location from TraceUnderCrosshairs
         FVector ToTarget = HitTarget - SocketTransform.GetLocation();
         FRotator TargetRotation = ToTarget.Rotation();
-        if(ProjectileClass && InstigatorPawn){
+        if(ProjectileClass && bPredict){
+            ABlasterCharacter* OwnerCharacter = Cast<ABlasterCharacter>(InstigatorPawn);
+            if(OwnerCharacter && OwnerCharacter->GetCombat()){
+                OwnerCharacter->GetCombat()->SpawnPredictedProjectile(ProjectileClass, SocketTransform.GetLocation(), TargetRotation, ScatterSeed);
+            }
+        }
+        else if(ProjectileClass){
             UWorld* World = GetWorld();
-            if(World){
-                //params for making a projectile
-                FActorSpawnParameters SpawnParams;
-                //Sets the projectiles owner to the weapons owner
-                SpawnParams.Owner = GetOwner();
-                SpawnParams.Instigator = InstigatorPawn;
-                World->SpawnActor<AProjectile>(ProjectileClass, SocketTransform.GetLocation(), TargetRotation, SpawnParams);
+            UProjectilePoolSubsystem* ProjectilePool = World ? World->GetSubsystem<UProjectilePoolSubsystem>() : nullptr;
+            //the pool launches an idle projectile if it has one, the projectiles owner is set to the weapons owner
+            AProjectile* Projectile = ProjectilePool ? ProjectilePool->AcquireProjectile(ProjectileClass, SocketTransform.GetLocation(), TargetRotation, GetOwner(), InstigatorPawn) : nullptr;
+            if(Projectile){
+                Projectile->SetShotId(ScatterSeed);
             }
         }
     }
@@ -16,10 +16,18 @@ class BLASTER_API AProjectileWeapon : public AWeapon
 
 public:
 
-	virtual void Fire(const FVector& HitTarget) override;
+	//ScatterSeed doubles as the shot id that matches the server projectile with the shooter's predicted one
+	virtual void FireWithSeed(const FVector& HitTarget, const FVector& TraceStart, int32 ScatterSeed) override;
+	virtual bool UsesFireSeed() const override { return bPredictProjectiles; }
+
+	FORCEINLINE TSubclassOf<class AProjectile> GetProjectileClass() const { return ProjectileClass; }
 
 private:
 
+	//the owning client spawns its own copy of the projectile right away instead of waiting for the server's to replicate
+	UPROPERTY(EditAnywhere, Category = "Projectile Prediction")
+	bool bPredictProjectiles = true;
+
 	UPROPERTY(EditAnywhere)
 	TSubclassOf<class AProjectile> ProjectileClass;
 };
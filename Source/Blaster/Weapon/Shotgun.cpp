@@ -2,51 +2,113 @@
 
 
 #include "Shotgun.h"
-#include "Engine/SkeletalMeshSocket.h"
 #include "Blaster/Character/BlasterCharacter.h"
 #include "Kismet/GameplayStatics.h"
 #include "Particles/ParticleSystemComponent.h"
 #include "Sound/SoundCue.h"
+#include "Blaster/BlasterComponents/LagCompensationComponent.h"
+#include "Blaster/BlasterComponents/CombatComponent.h"
 
-void AShotgun::Fire(const FVector& HitTarget)
+void AShotgun::BeginPlay()
+{
+	Super::BeginPlay();
+
+	PelletTraceDelegate.BindUObject(this, &ThisClass::OnPelletTraceDone);
+}
+
+void AShotgun::FireWithSeed(const FVector& HitTarget, const FVector& TraceStart, int32 ScatterSeed)
 {
 	AWeapon::Fire(HitTarget);
 	APawn* OwnerPawn = Cast<APawn>(GetOwner());
 	if (OwnerPawn == nullptr) return;
-	AController* InstigatorController = OwnerPawn->GetController();
-
-	const USkeletalMeshSocket* MuzzleFlashSocket = GetWeaponMesh()->GetSocketByName("MuzzleFlash");
-	if (MuzzleFlashSocket)
-	{
-		FTransform SocketTransform = MuzzleFlashSocket->GetSocketTransform(GetWeaponMesh());
-		FVector Start = SocketTransform.GetLocation();
-
-		TMap<ABlasterCharacter*, uint32> HitMap;
-		for (uint32 i = 0; i < NumberOfPellets; i++){
-			FHitResult FireHit;
-			WeaponTraceHit(Start, HitTarget, FireHit);
-
-			ABlasterCharacter* BlasterCharacter = Cast<ABlasterCharacter>(FireHit.GetActor());
-			if (BlasterCharacter && HasAuthority() && InstigatorController){
-				if (HitMap.Contains(BlasterCharacter)){
-					HitMap[BlasterCharacter]++;
-				}
-				else{
-					HitMap.Emplace(BlasterCharacter, 1);
-				}
-			}
+	UWorld* World = GetWorld();
+	if (World == nullptr) return;
+
+	//every machine builds the same pellets from the seed, so the impacts drawn here are the ones the server scores
+	TArray<FVector> TraceEnds;
+	TraceEndsWithScatter(TraceStart, HitTarget, ScatterSeed, NumberOfPellets, TraceEnds);
+	if (TraceEnds.Num() == 0) return;
+
+	//anything that depends on when or by whom the shot was fired is captured now, the results only come back next frame
+	const uint32 BlastId = NextBlastId++;
+	FPendingShotgunBlast& Blast = PendingBlasts.Add(BlastId);
+	Blast.TraceStart = TraceStart;
+	Blast.HitTarget = HitTarget;
+	Blast.ScatterSeed = ScatterSeed;
+	Blast.InstigatorController = OwnerPawn->GetController();
+	Blast.bLocallyControlled = OwnerPawn->IsLocallyControlled();
+	Blast.HitTime = GetServerSideRewindHitTime(OwnerPawn->GetController());
+	ABlasterCharacter* OwnerCharacter = Cast<ABlasterCharacter>(OwnerPawn);
+	Blast.FireSequence = OwnerCharacter && OwnerCharacter->GetCombat() ? OwnerCharacter->GetCombat()->GetLastFireSequence() : 0;
+	Blast.NumPending = TraceEnds.Num();
+	Blast.BeamEnds.Reserve(TraceEnds.Num());
+	Blast.PelletHits.Reserve(TraceEnds.Num());
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ShotgunPellet));
+	for (const FVector& TraceEnd : TraceEnds){
+		World->AsyncLineTraceByChannel(EAsyncTraceType::Single, TraceStart, TraceEnd, ECollisionChannel::ECC_Visibility, QueryParams, FCollisionResponseParams::DefaultResponseParam, &PelletTraceDelegate, BlastId);
+	}
+}
+
+void AShotgun::OnPelletTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	FPendingShotgunBlast* Blast = PendingBlasts.Find(TraceDatum.UserData);
+	if (Blast == nullptr) return;
+
+	//a single trace gives back at most one blocking hit
+	if (TraceDatum.OutHits.Num() > 0 && TraceDatum.OutHits[0].bBlockingHit){
+		Blast->BeamEnds.Add(TraceDatum.OutHits[0].ImpactPoint);
+		Blast->PelletHits.Add(TraceDatum.OutHits[0]);
+	}
+	else{
+		Blast->BeamEnds.Add(TraceDatum.End);
+	}
+
+	if (--Blast->NumPending == 0){
+		FinishBlast(*Blast);
+		PendingBlasts.Remove(TraceDatum.UserData);
+	}
+}
+
+void AShotgun::FinishBlast(FPendingShotgunBlast& Blast)
+{
+	for (const FVector& BeamEnd : Blast.BeamEnds){
+		SpawnBeam(Blast.TraceStart, BeamEnd);
+	}
 
-			if (ImpactParticles){
-				UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ImpactParticles, FireHit.ImpactPoint, FireHit.ImpactNormal.Rotation());
+	AController* InstigatorController = Blast.InstigatorController.Get();
+	TMap<ABlasterCharacter*, uint32> HitMap;
+	for (const FHitResult& FireHit : Blast.PelletHits){
+		ABlasterCharacter* BlasterCharacter = Cast<ABlasterCharacter>(FireHit.GetActor());
+		if (BlasterCharacter && InstigatorController){
+			if (HitMap.Contains(BlasterCharacter)){
+				HitMap[BlasterCharacter]++;
 			}
-			if (HitSound){
-				UGameplayStatics::PlaySoundAtLocation(this, HitSound, FireHit.ImpactPoint, .5f, FMath::FRandRange(-.5f, .5f));
+			else{
+				HitMap.Emplace(BlasterCharacter, 1);
 			}
 		}
-		for (auto HitPair : HitMap){
-			if (HitPair.Key && HasAuthority() && InstigatorController){
-				UGameplayStatics::ApplyDamage(HitPair.Key, Damage * HitPair.Value, InstigatorController, this, UDamageType::StaticClass());
-			}
+
+		if (ImpactParticles){
+			UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ImpactParticles, FireHit.ImpactPoint, FireHit.ImpactNormal.Rotation());
 		}
+		if (HitSound){
+			UGameplayStatics::PlaySoundAtLocation(this, HitSound, FireHit.ImpactPoint, .5f, FMath::FRandRange(-.5f, .5f));
+		}
+	}
+	bool bCauseAuthDamage = !bUseServerSideRewind || Blast.bLocallyControlled;
+	for (auto HitPair : HitMap){
+		if (HitPair.Key && HasAuthority() && bCauseAuthDamage && InstigatorController){
+			UGameplayStatics::ApplyDamage(HitPair.Key, Damage * HitPair.Value, InstigatorController, this, UDamageType::StaticClass());
+		}
+	}
+
+	//the server rebuilds the pellets from the shot it accepted, so only the characters that were hit need to be sent
+	ABlasterCharacter* OwnerCharacter = Cast<ABlasterCharacter>(GetOwner());
+	bool bRequestScore = !HasAuthority() && bUseServerSideRewind && Blast.bLocallyControlled && HitMap.Num() > 0;
+	if (bRequestScore && OwnerCharacter && OwnerCharacter->GetLagCompensation()){
+		TArray<ABlasterCharacter*> HitCharacters;
+		HitMap.GenerateKeyArray(HitCharacters);
+		OwnerCharacter->GetLagCompensation()->ShotgunServerScoreRequest(HitCharacters, Blast.FireSequence, Blast.HitTime);
 	}
 }
@@ -4,8 +4,31 @@
 
 #include "CoreMinimal.h"
 #include "HitScanWeapon.h"
+#include "WorldCollision.h"
 #include "Shotgun.generated.h"
 
+class ABlasterCharacter;
+
+//a shotgun blast whose pellet traces are still running on the async trace queue
+struct FPendingShotgunBlast
+{
+	FVector TraceStart;
+	FVector HitTarget;
+	int32 ScatterSeed = 0;
+	//server time the shooter was seeing when it fired, kept for the rewind request
+	float HitTime = 0.f;
+	//fire command of the shot, which the rewind request names so the server can match it to the shot it accepted
+	uint16 FireSequence = 0;
+	bool bLocallyControlled = false;
+	TWeakObjectPtr<AController> InstigatorController;
+
+	//traces still waiting on a result
+	int32 NumPending = 0;
+	//one entry per pellet, the beam ends where the pellet stopped
+	TArray<FVector> BeamEnds;
+	TArray<FHitResult> PelletHits;
+};
+
 /**
  * 
  */
@@ -14,9 +37,31 @@ class BLASTER_API AShotgun : public AHitScanWeapon
 {
 	GENERATED_BODY()
 public:
-	virtual void Fire(const FVector& HitTarget) override;
+	virtual void FireWithSeed(const FVector& HitTarget, const FVector& TraceStart, int32 ScatterSeed) override;
+	virtual bool UsesFireSeed() const override { return true; }
+
+	FORCEINLINE uint32 GetNumberOfPellets() const { return NumberOfPellets; }
+
+protected:
+	virtual void BeginPlay() override;
+
 private:
 
 	UPROPERTY(EditAnywhere, Category = "Weapon Scatter")
 	uint32 NumberOfPellets = 10;
+
+	/**
+	 * Async pellet traces
+	 * All pellets of a blast are queued on the world's async trace queue instead of being traced one after another on
+	 * the game thread. The results come back next frame and the blast is scored once the last one arrives
+	 */
+
+	FTraceDelegate PelletTraceDelegate;
+
+	void OnPelletTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+	void FinishBlast(FPendingShotgunBlast& Blast);
+
+	//keyed by the id passed along as the trace user data
+	TMap<uint32, FPendingShotgunBlast> PendingBlasts;
+	uint32 NextBlastId = 0;
 };
@@ -6,12 +6,16 @@
 #include "Components/WidgetComponent.h"
 #include "Blaster/Character/BlasterCharacter.h"
 #include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
 #include "Animation/AnimationAsset.h"
 #include "Components/SkeletalMeshComponent.h"
 #include "Casing.h"
+#include "CasingEjectorComponent.h"
 #include "Engine/SkeletalMeshSocket.h"
+#include "TimerManager.h"
 #include "Blaster/PlayerController/BlasterPlayerController.h"
 #include "Blaster/BlasterComponents/CombatComponent.h"
+#include "Blaster/Replication/BlasterReplicationGraph.h"
 
 // Sets default values
 AWeapon::AWeapon()
@@ -26,6 +30,10 @@ AWeapon::AWeapon()
 	// in the same area as the server so that the clients can pick up the weapons
 	SetReplicateMovement(true);
 
+	//weapons lying around on the map don't need to be looked at until someone picks them up. Placed weapons start
+	//dormant and spawned ones go dormant after their first update
+	NetDormancy = DORM_Initial;
+
 	WeaponMesh = CreateDefaultSubobject<USkeletalMeshComponent>(TEXT("WeaponMesh"));
 	SetRootComponent(WeaponMesh);
 
@@ -52,6 +60,9 @@ AWeapon::AWeapon()
 
 	PickupWidget = CreateDefaultSubobject<UWidgetComponent>(TEXT("PickupWidget"));
 	PickupWidget->SetupAttachment(RootComponent);
+
+	CasingEjector = CreateDefaultSubobject<UCasingEjectorComponent>(TEXT("CasingEjector"));
+	CasingEjector->SetupAttachment(RootComponent);
 }
 
 void AWeapon::EnableCustomDepth(bool bEnable)
@@ -66,8 +77,11 @@ void AWeapon::GetLifetimeReplicatedProps(TArray<FLifetimeProperty> &OutLifetimeP
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME(AWeapon, WeaponState);
-	DOREPLIFETIME(AWeapon, Ammo);
+	//pushed, both only change when the weapon is fired, reloaded, picked up or dropped
+	FDoRepLifetimeParams PushParams;
+	PushParams.bIsPushBased = true;
+	DOREPLIFETIME_WITH_PARAMS_FAST(AWeapon, WeaponState, PushParams);
+	DOREPLIFETIME_WITH_PARAMS_FAST(AWeapon, Ammo, PushParams);
 }
 
 void AWeapon::OnRep_Owner()
@@ -111,20 +125,36 @@ void AWeapon::Fire(const FVector &HitTarget)
 		WeaponMesh->PlayAnimation(FireAnimation, false);
 	}
 
-	if(CasingClass){
+	if(CasingClass && CasingEjector && ShouldPlayDetailEffects()){
 		const USkeletalMeshSocket* AmmoEjectSocket = WeaponMesh->GetSocketByName(FName("AmmoEject"));
 		if(AmmoEjectSocket){
 			FTransform SocketTransform = AmmoEjectSocket->GetSocketTransform(WeaponMesh);
-
-			UWorld* World = GetWorld();
-			if(World){
-				World->SpawnActor<ACasing>(CasingClass, SocketTransform.GetLocation(), SocketTransform.GetRotation().Rotator());
-			}
+			CasingEjector->EjectCasing(SocketTransform);
 		}
 	}
 	SpendRound();
 }
 
+bool AWeapon::ShouldPlayDetailEffects()
+{
+	BlasterOwnerCharacter = BlasterOwnerCharacter == nullptr ? Cast<ABlasterCharacter>(GetOwner()) : BlasterOwnerCharacter;
+	return BlasterOwnerCharacter == nullptr || BlasterOwnerCharacter->ShouldPlayDetailEffects();
+}
+
+void AWeapon::FireWithSeed(const FVector &HitTarget, const FVector &TraceStart, int32 ScatterSeed)
+{
+	Fire(HitTarget);
+}
+
+FVector AWeapon::GetMuzzleLocation() const
+{
+	const USkeletalMeshSocket* MuzzleFlashSocket = WeaponMesh->GetSocketByName(FName("MuzzleFlash"));
+	if(MuzzleFlashSocket){
+		return MuzzleFlashSocket->GetSocketTransform(WeaponMesh).GetLocation();
+	}
+	return GetActorLocation();
+}
+
 // Called when the game starts or when spawned
 void AWeapon::BeginPlay()
 {
@@ -142,6 +172,10 @@ void AWeapon::BeginPlay()
 		//we want the widget to be off by default on game start
 		PickupWidget->SetVisibility(false);
 	}
+
+	if(CasingEjector){
+		CasingEjector->InitializeFromCasing(CasingClass);
+	}
 }
 
 void AWeapon::OnSphereOverlap(UPrimitiveComponent *OverlappedComponent, AActor *OtherActor, UPrimitiveComponent *OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult &SweepResult)
@@ -178,7 +212,13 @@ void AWeapon::ShowPickupWidget(bool bShowWidget)
 
 void AWeapon::SetWeaponState(EWeaponState State)
 {
+	//has to be awake before the change or the new state never goes out
+	if(HasAuthority()){
+		GetWorldTimerManager().ClearTimer(SettleCheckTimer);
+		SetNetDormancy(DORM_Awake);
+	}
 	WeaponState = State;
+	MARK_PROPERTY_DIRTY_FROM_NAME(AWeapon, WeaponState, this);
 
 	switch(WeaponState){
 		case EWeaponState::EWS_Equipped:
@@ -215,10 +255,28 @@ void AWeapon::SetWeaponState(EWeaponState State)
 			WeaponMesh->SetCustomDepthStencilValue(CUSTOM_DEPTH_BLUE);
 			WeaponMesh->MarkRenderStateDirty();
 			EnableCustomDepth(true);
+
+			if(HasAuthority()){
+				StartSettleCheck();
+			}
 			break;
 	}
 }
 
+void AWeapon::StartSettleCheck()
+{
+	GetWorldTimerManager().SetTimer(SettleCheckTimer, this, &ThisClass::SettleCheck, SettleCheckInterval, true);
+}
+
+void AWeapon::SettleCheck()
+{
+	if(WeaponMesh && WeaponMesh->IsSimulatingPhysics() && WeaponMesh->RigidBodyIsAwake()) {return;}
+
+	//the channel sends whatever is still pending, including the resting transform, before it actually goes dormant
+	GetWorldTimerManager().ClearTimer(SettleCheckTimer);
+	SetNetDormancy(DORM_DormantAll);
+}
+
 void AWeapon::OnRep_WeaponState()
 {
 	switch(WeaponState){
@@ -265,6 +323,7 @@ void AWeapon::OnRep_Ammo()
 void AWeapon::SpendRound()
 {
 	Ammo = FMath::Clamp(Ammo - 1, 0, MagCapacity);
+	MARK_PROPERTY_DIRTY_FROM_NAME(AWeapon, Ammo, this);
 	SetHUDAmmo();
 }
 
@@ -273,6 +332,8 @@ void AWeapon::Dropped()
 	SetWeaponState(EWeaponState::EWS_Dropped);
 	FDetachmentTransformRules DetachRules(EDetachmentRule::KeepWorld, true);
 	WeaponMesh->DetachFromComponent(DetachRules);
+	//back into the replication grid before the owner goes away
+	UBlasterReplicationGraph::NotifyWeaponDropped(Cast<ABlasterCharacter>(GetOwner()), this);
 	SetOwner(nullptr);
 
 	BlasterOwnerCharacter = nullptr;
@@ -282,5 +343,6 @@ void AWeapon::Dropped()
 void AWeapon::AddAmmo(int32 AmmoToAdd)
 {
 	Ammo = FMath::Clamp(Ammo - AmmoToAdd, 0, MagCapacity);
+	MARK_PROPERTY_DIRTY_FROM_NAME(AWeapon, Ammo, this);
 	SetHUDAmmo();
 }
@@ -55,6 +55,16 @@ public:
 
 	virtual void Fire(const FVector& HitTarget);
 
+	//fires from the muzzle location and with the spread seed the shooter picked, so every machine rolls the same shot
+	//weapons without any spread just fire at HitTarget
+	virtual void FireWithSeed(const FVector& HitTarget, const FVector& TraceStart, int32 ScatterSeed);
+
+	//world location of the MuzzleFlash socket, or the weapon location if the mesh has no such socket
+	FVector GetMuzzleLocation() const;
+
+	//whether FireWithSeed does anything with the seed, shots from weapons that don't leave it out of the fire command
+	virtual bool UsesFireSeed() const { return false; }
+
 	void Dropped();
 	void AddAmmo(int32 AmmoToAdd);
 
@@ -109,6 +119,9 @@ public:
 
 	FORCEINLINE EWeaponType GetWeaponType() const { return WeaponType; }
 
+	//false while the owner is a proxy too far away or off screen for beams and casings to be worth it
+	bool ShouldPlayDetailEffects();
+
 	FORCEINLINE int32 GetAmmo() const { return Ammo; }
 	FORCEINLINE int32 GetMagCapacity() const { return MagCapacity; }
 
@@ -145,6 +158,20 @@ private:
 	UFUNCTION()
 	void OnRep_WeaponState();
 
+	/**
+	 * Dormancy
+	 */
+
+	//a dropped weapon goes dormant once its physics has settled, anything that changes the weapon state wakes it back up
+	void StartSettleCheck();
+	void SettleCheck();
+
+	FTimerHandle SettleCheckTimer;
+
+	//how often a dropped weapon checks whether it has come to rest
+	UPROPERTY(EditAnywhere, Category = "Weapon Properties")
+	float SettleCheckInterval = 0.5f;
+
 	UPROPERTY(VisibleAnywhere, Category = "Weapon Properties")
 	class UWidgetComponent* PickupWidget;
 
@@ -154,6 +181,10 @@ private:
 	UPROPERTY(EditAnywhere)
 	TSubclassOf<class ACasing> CasingClass;
 
+	//draws the ejected casings, CasingClass only supplies the mesh, sound and impulse
+	UPROPERTY(VisibleAnywhere, Category = "Weapon Properties")
+	class UCasingEjectorComponent* CasingEjector;
+
 	UPROPERTY(EditAnywhere, ReplicatedUsing = OnRep_Ammo)
 	int32 Ammo;
 